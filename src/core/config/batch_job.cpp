@@ -0,0 +1,35 @@
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+std::string Config::get_batch_jobs_table_name() { return "FLOCKMTL_BATCH_JOB_INTERNAL_TABLE"; }
+
+void Config::ConfigBatchJobTable(duckdb::Connection& con, std::string& schema_name, const ConfigType type) {
+    // Batch jobs belong to the database that submitted them
+    if (type != ConfigType::LOCAL) {
+        return;
+    }
+    const std::string table_name = Config::get_batch_jobs_table_name();
+
+    auto result = con.Query(duckdb_fmt::format(" SELECT table_name "
+                                               "   FROM information_schema.tables "
+                                               "  WHERE table_schema = '{}' "
+                                               "    AND table_name = '{}'; ",
+                                               schema_name, table_name));
+    if (result->RowCount() == 0) {
+        con.Query(duckdb_fmt::format(" CREATE TABLE {}.{} ( "
+                                     " job_key VARCHAR NOT NULL PRIMARY KEY, "
+                                     " provider_name VARCHAR NOT NULL, "
+                                     " model VARCHAR NOT NULL, "
+                                     " endpoint VARCHAR NOT NULL, "
+                                     " batch_id VARCHAR NOT NULL, "
+                                     " status VARCHAR NOT NULL, "
+                                     " output_file_id VARCHAR, "
+                                     " created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+                                     " updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP "
+                                     " ); ",
+                                     schema_name, table_name));
+    }
+}
+
+} // namespace flockmtl
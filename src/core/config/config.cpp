@@ -75,6 +75,8 @@ void Config::ConfigureTables(duckdb::Connection& con, const ConfigType type) {
     ConfigSchema(con, schema);
     ConfigModelTable(con, schema, type);
     ConfigPromptTable(con, schema, type);
+    ConfigBatchJobTable(con, schema, type);
+    ConfigVectorIndexTables(con, schema, type);
     con.Commit();
 }
 
@@ -0,0 +1,60 @@
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+std::string Config::get_vector_indexes_table_name() { return "FLOCKMTL_VECTOR_INDEX_INTERNAL_TABLE"; }
+
+std::string Config::get_vector_index_nodes_table_name() { return "FLOCKMTL_VECTOR_INDEX_NODE_INTERNAL_TABLE"; }
+
+void Config::ConfigVectorIndexTables(duckdb::Connection& con, std::string& schema_name, const ConfigType type) {
+    // Indexes point to tables of the database they were created in
+    if (type != ConfigType::LOCAL) {
+        return;
+    }
+
+    auto result = con.Query(duckdb_fmt::format(" SELECT table_name "
+                                               "   FROM information_schema.tables "
+                                               "  WHERE table_schema = '{}' "
+                                               "    AND table_name = '{}'; ",
+                                               schema_name, get_vector_indexes_table_name()));
+    if (result->RowCount() == 0) {
+        con.Query(duckdb_fmt::format(" CREATE TABLE {}.{} ( "
+                                     " index_name VARCHAR NOT NULL PRIMARY KEY, "
+                                     " table_name VARCHAR NOT NULL, "
+                                     " key_column VARCHAR NOT NULL, "
+                                     " embedding_column VARCHAR NOT NULL, "
+                                     " metric VARCHAR NOT NULL, "
+                                     " dimensions INTEGER NOT NULL, "
+                                     " m INTEGER NOT NULL, "
+                                     " ef_construction INTEGER NOT NULL, "
+                                     " entry_point INTEGER NOT NULL, "
+                                     " max_level INTEGER NOT NULL, "
+                                     " updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP "
+                                     " ); ",
+                                     schema_name, get_vector_indexes_table_name()));
+    }
+
+    result = con.Query(duckdb_fmt::format(" SELECT table_name "
+                                          "   FROM information_schema.tables "
+                                          "  WHERE table_schema = '{}' "
+                                          "    AND table_name = '{}'; ",
+                                          schema_name, get_vector_index_nodes_table_name()));
+    if (result->RowCount() == 0) {
+        con.Query(duckdb_fmt::format(" CREATE TABLE {}.{} ( "
+                                     " index_name VARCHAR NOT NULL, "
+                                     " node_id INTEGER NOT NULL, "
+                                     " row_key BIGINT NOT NULL, "
+                                     " neighbors BLOB NOT NULL, "
+                                     " vector_hash UBIGINT, "
+                                     " vector BLOB "
+                                     " ); ",
+                                     schema_name, get_vector_index_nodes_table_name()));
+    } else {
+        con.Query(duckdb_fmt::format(" ALTER TABLE {}.{} ADD COLUMN IF NOT EXISTS vector_hash UBIGINT; ", schema_name,
+                                     get_vector_index_nodes_table_name()));
+        con.Query(duckdb_fmt::format(" ALTER TABLE {}.{} ADD COLUMN IF NOT EXISTS vector BLOB; ", schema_name,
+                                     get_vector_index_nodes_table_name()));
+    }
+}
+
+} // namespace flockmtl
@@ -2,6 +2,8 @@
 
 #include "flockmtl/core/common.hpp"
 #include "flockmtl/core/config.hpp"
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -29,6 +31,50 @@ void ModelParser::Parse(const std::string& query, std::unique_ptr<QueryStatement
     }
 }
 
+void ModelParser::ValidateModelArgs(const nlohmann::json& model_args) {
+    const std::set<std::string> required_keys = {"context_window", "max_output_tokens"};
+    const std::set<std::string> optional_keys = {"max_retries",         "retry_base_delay_ms", "retry_max_delay_ms",
+                                                 "requests_per_minute", "tokens_per_minute",   "execution_mode",
+                                                 "batch_poll_interval_seconds", "dimensions",
+                                                 "stream", "max_concurrent_requests", "secret_name"};
+    for (const auto& key : required_keys) {
+        if (!model_args.contains(key)) {
+            throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
+        }
+    }
+    for (auto it = model_args.begin(); it != model_args.end(); ++it) {
+        if (required_keys.count(it.key()) == 0 && optional_keys.count(it.key()) == 0) {
+            throw std::runtime_error(duckdb_fmt::format("Unexpected key '{}' in model_args.", it.key()));
+        }
+    }
+    if (const auto it = model_args.find("secret_name"); it != model_args.end()) {
+        // A single secret, a comma separated list of secrets, or an array of secrets for a pool of endpoints
+        const auto is_string = [](const nlohmann::json& value) { return value.is_string(); };
+        if (!is_string(*it) && (!it->is_array() || it->empty() || !std::all_of(it->begin(), it->end(), is_string))) {
+            throw std::runtime_error("Expected secret_name to be a string or an array of strings in model_args.");
+        }
+    }
+
+    // Checked here so that a bad value fails the statement instead of every later call to the model
+    const auto check_integer = [&model_args](const std::string& key, const int64_t minimum) {
+        if (const auto it = model_args.find(key); it != model_args.end()) {
+            if (!it->is_number_integer() || it->get<int64_t>() < minimum ||
+                it->get<int64_t>() > std::numeric_limits<int32_t>::max()) {
+                throw std::runtime_error(
+                    duckdb_fmt::format("Expected {} to be an integer of at least {} in model_args.", key, minimum));
+            }
+        }
+    };
+    for (const auto& key : {"max_retries", "retry_base_delay_ms", "retry_max_delay_ms", "requests_per_minute",
+                            "tokens_per_minute", "max_concurrent_requests"}) {
+        check_integer(key, 0);
+    }
+    check_integer("batch_poll_interval_seconds", 1);
+    if (const auto it = model_args.find("stream"); it != model_args.end() && !it->is_boolean()) {
+        throw std::runtime_error("Expected stream to be a boolean in model_args.");
+    }
+}
+
 void ModelParser::ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement) {
     auto token = tokenizer.NextToken();
     auto value = duckdb::StringUtil::Upper(token.value);
@@ -89,14 +135,7 @@ void ModelParser::ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QuerySt
         throw std::runtime_error("Expected json value for the model_args.");
     }
     auto model_args = nlohmann::json::parse(token.value);
-    const std::set<std::string> expected_keys = {"context_window", "max_output_tokens"};
-    std::set<std::string> json_keys;
-    for (auto it = model_args.begin(); it != model_args.end(); ++it) {
-        json_keys.insert(it.key());
-    }
-    if (json_keys != expected_keys) {
-        throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
-    }
+    ValidateModelArgs(model_args);
 
     token = tokenizer.NextToken();
     if (token.type != TokenType::PARENTHESIS || token.value != ")") {
@@ -216,14 +255,7 @@ void ModelParser::ParseUpdateModel(Tokenizer& tokenizer, std::unique_ptr<QuerySt
             throw std::runtime_error("Expected json value for the model_args.");
         }
         auto new_model_args = nlohmann::json::parse(token.value);
-        const std::set<std::string> expected_keys = {"context_window", "max_output_tokens"};
-        std::set<std::string> json_keys;
-        for (auto it = new_model_args.begin(); it != new_model_args.end(); ++it) {
-            json_keys.insert(it.key());
-        }
-        if (json_keys != expected_keys) {
-            throw std::runtime_error("Expected keys: context_window, max_output_tokens in model_args.");
-        }
+        ValidateModelArgs(new_model_args);
 
         token = tokenizer.NextToken();
         if (token.type != TokenType::PARENTHESIS || token.value != ")") {
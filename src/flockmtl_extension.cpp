@@ -14,6 +14,7 @@ namespace duckdb {
 
 static void LoadInternal(DatabaseInstance& instance) {
     flockmtl::Config::Configure(instance);
+    flockmtl::RequestScheduler::RegisterSettings(instance);
 
     // Register the custom parser
     auto& config = DBConfig::GetConfig(instance);
@@ -18,6 +18,21 @@ void AggregateFunctionBase::ValidateArguments(duckdb::Vector inputs[], idx_t inp
     }
 }
 
+duckdb::unique_ptr<duckdb::FunctionData> AggregateBindData::Copy() const {
+    return duckdb::make_uniq<AggregateBindData>(origin);
+}
+
+bool AggregateBindData::Equals(const duckdb::FunctionData& other) const {
+    const auto& other_origin = other.Cast<AggregateBindData>().origin;
+    return origin.query_id == other_origin.query_id && origin.priority == other_origin.priority;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+AggregateFunctionBase::Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+                            duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    return duckdb::make_uniq<AggregateBindData>(RequestScheduler::GetOrigin(context));
+}
+
 std::tuple<nlohmann::json, nlohmann::json, std::vector<nlohmann::json>>
 AggregateFunctionBase::CastInputsToJson(duckdb::Vector inputs[], idx_t count) {
     auto model_details_json = CastVectorOfStructsToJson(inputs[0], 1)[0];
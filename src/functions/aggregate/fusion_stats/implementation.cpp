@@ -0,0 +1,139 @@
+#include "flockmtl/functions/aggregate/fusion_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flockmtl {
+
+duckdb::LogicalType FusionStats::GetResultType() {
+    duckdb::child_list_t<duckdb::LogicalType> fields = {{"count", duckdb::LogicalType::BIGINT},
+                                                        {"min", duckdb::LogicalType::DOUBLE},
+                                                        {"max", duckdb::LogicalType::DOUBLE},
+                                                        {"mean", duckdb::LogicalType::DOUBLE},
+                                                        {"stddev", duckdb::LogicalType::DOUBLE}};
+    return duckdb::LogicalType::STRUCT(fields);
+}
+
+void FusionStats::Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p) {
+    *reinterpret_cast<FusionStatsState*>(state_p) = {0, 0, 0, 0, 0};
+}
+
+void FusionStats::Update(FusionStatsState& state, const double value) {
+    state.count++;
+    if (state.count == 1) {
+        state.min = state.max = state.mean = value;
+        state.m2 = 0;
+        return;
+    }
+    state.min = std::min(state.min, value);
+    state.max = std::max(state.max, value);
+    const auto delta = value - state.mean;
+    state.mean += delta / static_cast<double>(state.count);
+    state.m2 += delta * (value - state.mean);
+}
+
+void FusionStats::Merge(FusionStatsState& target, const FusionStatsState& source) {
+    if (source.count == 0) {
+        return;
+    }
+    if (target.count == 0) {
+        target = source;
+        return;
+    }
+    // Chan et al. pairwise update, so partial states of parallel and windowed aggregation merge exactly
+    const auto count = target.count + source.count;
+    const auto delta = source.mean - target.mean;
+    const auto source_weight = static_cast<double>(source.count) / static_cast<double>(count);
+    target.m2 += source.m2 + delta * delta * static_cast<double>(target.count) * source_weight;
+    target.mean += delta * source_weight;
+    target.min = std::min(target.min, source.min);
+    target.max = std::max(target.max, source.max);
+    target.count = count;
+}
+
+void FusionStats::Operation(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                            duckdb::Vector& states, idx_t count) {
+    duckdb::UnifiedVectorFormat input_format;
+    duckdb::UnifiedVectorFormat states_format;
+    inputs[0].ToUnifiedFormat(count, input_format);
+    states.ToUnifiedFormat(count, states_format);
+    const auto values = duckdb::UnifiedVectorFormat::GetData<double>(input_format);
+    const auto state_pointers = duckdb::UnifiedVectorFormat::GetData<FusionStatsState*>(states_format);
+
+    for (idx_t row = 0; row < count; row++) {
+        const auto input_index = input_format.sel->get_index(row);
+        if (input_format.validity.RowIsValid(input_index)) {
+            Update(*state_pointers[states_format.sel->get_index(row)], values[input_index]);
+        }
+    }
+}
+
+void FusionStats::SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data,
+                               idx_t input_count, duckdb::data_ptr_t state_p, idx_t count) {
+    duckdb::UnifiedVectorFormat input_format;
+    inputs[0].ToUnifiedFormat(count, input_format);
+    const auto values = duckdb::UnifiedVectorFormat::GetData<double>(input_format);
+    auto& state = *reinterpret_cast<FusionStatsState*>(state_p);
+
+    if (inputs[0].GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR) {
+        // A constant adds `count` times the same value, which has no spread of its own
+        if (input_format.validity.RowIsValid(0)) {
+            FusionStatsState constant = {static_cast<int64_t>(count), values[0], values[0], values[0], 0};
+            Merge(state, constant);
+        }
+        return;
+    }
+    for (idx_t row = 0; row < count; row++) {
+        const auto input_index = input_format.sel->get_index(row);
+        if (input_format.validity.RowIsValid(input_index)) {
+            Update(state, values[input_index]);
+        }
+    }
+}
+
+void FusionStats::Combine(duckdb::Vector& source, duckdb::Vector& target, duckdb::AggregateInputData& aggr_input_data,
+                          idx_t count) {
+    const auto source_states = duckdb::FlatVector::GetData<FusionStatsState*>(source);
+    const auto target_states = duckdb::FlatVector::GetData<FusionStatsState*>(target);
+    for (idx_t i = 0; i < count; i++) {
+        Merge(*target_states[i], *source_states[i]);
+    }
+}
+
+void FusionStats::Write(const FusionStatsState& state, duckdb::Vector& result, const idx_t row) {
+    auto& fields = duckdb::StructVector::GetEntries(result);
+    duckdb::FlatVector::GetData<int64_t>(*fields[COUNT])[row] = state.count;
+    duckdb::FlatVector::GetData<double>(*fields[MIN])[row] = state.min;
+    duckdb::FlatVector::GetData<double>(*fields[MAX])[row] = state.max;
+    duckdb::FlatVector::GetData<double>(*fields[MEAN])[row] = state.mean;
+    // Population standard deviation: the scores are the whole result, not a sample of it
+    duckdb::FlatVector::GetData<double>(*fields[STDDEV])[row] =
+        std::sqrt(state.m2 / static_cast<double>(state.count));
+}
+
+void FusionStats::Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data,
+                           duckdb::Vector& result, idx_t count, idx_t offset) {
+    if (states.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR) {
+        result.SetVectorType(duckdb::VectorType::CONSTANT_VECTOR);
+        const auto& state = **duckdb::ConstantVector::GetData<FusionStatsState*>(states);
+        if (state.count == 0) {
+            duckdb::ConstantVector::SetNull(result, true);
+        } else {
+            Write(state, result, 0);
+        }
+        return;
+    }
+
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    const auto state_pointers = duckdb::FlatVector::GetData<FusionStatsState*>(states);
+    for (idx_t i = 0; i < count; i++) {
+        const auto row = i + offset;
+        if (state_pointers[i]->count == 0) {
+            duckdb::FlatVector::SetNull(result, row, true);
+        } else {
+            Write(*state_pointers[i], result, row);
+        }
+    }
+}
+
+} // namespace flockmtl
@@ -0,0 +1,15 @@
+#include "flockmtl/functions/aggregate/fusion_stats.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void AggregateRegistry::RegisterFusionStats(duckdb::DatabaseInstance& db) {
+    auto fusion_stats = duckdb::AggregateFunction(
+        "fusion_stats", {duckdb::LogicalType::DOUBLE}, FusionStats::GetResultType(),
+        duckdb::AggregateFunction::StateSize<FusionStatsState>, FusionStats::Initialize, FusionStats::Operation,
+        FusionStats::Combine, FusionStats::Finalize, FusionStats::SimpleUpdate);
+
+    duckdb::ExtensionUtil::RegisterFunction(db, fusion_stats);
+}
+
+} // namespace flockmtl
@@ -8,7 +8,7 @@ void AggregateRegistry::RegisterLlmFirst(duckdb::DatabaseInstance& db) {
         "llm_first", {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmFirstOrLast::Initialize, LlmFirstOrLast::Operation, LlmFirstOrLast::Combine,
-        LlmFirstOrLast::Finalize<AggregateFunctionType::FIRST>, LlmFirstOrLast::SimpleUpdate);
+        LlmFirstOrLast::Finalize<AggregateFunctionType::FIRST>, LlmFirstOrLast::SimpleUpdate, LlmFirstOrLast::Bind);
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -18,7 +18,7 @@ void AggregateRegistry::RegisterLlmLast(duckdb::DatabaseInstance& db) {
         "llm_last", {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
         LlmFirstOrLast::Initialize, LlmFirstOrLast::Operation, LlmFirstOrLast::Combine,
-        LlmFirstOrLast::Finalize<AggregateFunctionType::LAST>, LlmFirstOrLast::SimpleUpdate);
+        LlmFirstOrLast::Finalize<AggregateFunctionType::LAST>, LlmFirstOrLast::SimpleUpdate, LlmFirstOrLast::Bind);
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -7,7 +7,8 @@ void AggregateRegistry::RegisterLlmReduce(duckdb::DatabaseInstance& db) {
     auto string_concat = duckdb::AggregateFunction(
         "llm_reduce", {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY, duckdb::LogicalType::ANY},
         duckdb::LogicalType::VARCHAR, duckdb::AggregateFunction::StateSize<AggregateFunctionState>,
-        LlmReduce::Initialize, LlmReduce::Operation, LlmReduce::Combine, LlmReduce::Finalize, LlmReduce::SimpleUpdate);
+        LlmReduce::Initialize, LlmReduce::Operation, LlmReduce::Combine, LlmReduce::Finalize, LlmReduce::SimpleUpdate,
+        LlmReduce::Bind);
 
     duckdb::ExtensionUtil::RegisterFunction(db, string_concat);
 }
@@ -0,0 +1,243 @@
+#include "flockmtl/functions/aggregate/vector_aggregate.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "flockmtl/vector/float_vector.hpp"
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+// The sums are kept in double precision, so that billions of rows can be added without losing the small ones
+constexpr bool IsSum(const VectorAggregateKind kind) {
+    return kind == VectorAggregateKind::SUM || kind == VectorAggregateKind::MEAN ||
+           kind == VectorAggregateKind::NORMALIZED_MEAN;
+}
+
+} // namespace
+
+duckdb::AggregateFunction VectorAggregate::GetFunction(const std::string& name, const VectorAggregateKind kind) {
+    auto make_function = [&](auto operation, auto simple_update, auto combine, auto finalize) {
+        auto function = duckdb::AggregateFunction(
+            name, {duckdb::LogicalType::ANY}, duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT),
+            duckdb::AggregateFunction::StateSize<VectorAggregateState>, Initialize, operation, combine, finalize,
+            simple_update, Bind);
+        function.order_dependent = duckdb::AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+        return function;
+    };
+    switch (kind) {
+    case VectorAggregateKind::SUM:
+        return make_function(Operation<VectorAggregateKind::SUM>, SimpleUpdate<VectorAggregateKind::SUM>,
+                             Combine<VectorAggregateKind::SUM>, Finalize<VectorAggregateKind::SUM>);
+    case VectorAggregateKind::MEAN:
+        return make_function(Operation<VectorAggregateKind::MEAN>, SimpleUpdate<VectorAggregateKind::MEAN>,
+                             Combine<VectorAggregateKind::MEAN>, Finalize<VectorAggregateKind::MEAN>);
+    case VectorAggregateKind::NORMALIZED_MEAN:
+        return make_function(Operation<VectorAggregateKind::NORMALIZED_MEAN>,
+                             SimpleUpdate<VectorAggregateKind::NORMALIZED_MEAN>,
+                             Combine<VectorAggregateKind::NORMALIZED_MEAN>,
+                             Finalize<VectorAggregateKind::NORMALIZED_MEAN>);
+    case VectorAggregateKind::MIN:
+        return make_function(Operation<VectorAggregateKind::MIN>, SimpleUpdate<VectorAggregateKind::MIN>,
+                             Combine<VectorAggregateKind::MIN>, Finalize<VectorAggregateKind::MIN>);
+    case VectorAggregateKind::MAX:
+        return make_function(Operation<VectorAggregateKind::MAX>, SimpleUpdate<VectorAggregateKind::MAX>,
+                             Combine<VectorAggregateKind::MAX>, Finalize<VectorAggregateKind::MAX>);
+    default:
+        throw std::runtime_error("Unsupported vector aggregate.");
+    }
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorAggregate::Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+                      duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& args) {
+    function.arguments[0] = FloatVectorReader::GetCastType(args[0]->return_type, function.name);
+    function.return_type = function.arguments[0];
+    return nullptr;
+}
+
+void VectorAggregate::Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p) {
+    *reinterpret_cast<VectorAggregateState*>(state_p) = {0, 0, nullptr};
+}
+
+void VectorAggregate::CheckDimensions(const VectorAggregateState& state, const idx_t size) {
+    if (state.dimensions != size) {
+        throw std::runtime_error(
+            duckdb_fmt::format("Cannot aggregate vectors of {} and {} dimensions.", state.dimensions, size));
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Update(VectorAggregateState& state, const float* data, const idx_t size, const int64_t weight,
+                             duckdb::ArenaAllocator& allocator) {
+    if (state.count == 0) {
+        state.dimensions = size;
+        if constexpr (IsSum(KIND)) {
+            state.values = allocator.Allocate(size * sizeof(double));
+            std::fill_n(reinterpret_cast<double*>(state.values), size, 0.0);
+        } else {
+            state.values = allocator.Allocate(size * sizeof(float));
+            std::memcpy(state.values, data, size * sizeof(float));
+            state.count = weight;
+            return;
+        }
+    } else {
+        CheckDimensions(state, size);
+    }
+    state.count += weight;
+
+    if constexpr (KIND == VectorAggregateKind::NORMALIZED_MEAN) {
+        // Every vector contributes its direction only; a zero vector has none and adds nothing
+        const auto norm = std::sqrt(VectorKernels::SquaredNorm(data, size));
+        const auto scale = norm > 0 ? static_cast<float>(weight) / norm : 0.0f;
+        VectorKernels::Accumulate(reinterpret_cast<double*>(state.values), data, scale, size);
+    } else if constexpr (IsSum(KIND)) {
+        VectorKernels::Accumulate(reinterpret_cast<double*>(state.values), data, static_cast<float>(weight), size);
+    } else if constexpr (KIND == VectorAggregateKind::MIN) {
+        VectorKernels::Minimum(reinterpret_cast<float*>(state.values), data, size);
+    } else {
+        VectorKernels::Maximum(reinterpret_cast<float*>(state.values), data, size);
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Merge(VectorAggregateState& target, const VectorAggregateState& source,
+                            duckdb::ArenaAllocator& allocator) {
+    if (source.count == 0) {
+        return;
+    }
+    if (target.count == 0) {
+        // The source may live in another arena, so its values are copied rather than shared
+        const auto bytes = source.dimensions * (IsSum(KIND) ? sizeof(double) : sizeof(float));
+        target = source;
+        target.values = allocator.Allocate(bytes);
+        std::memcpy(target.values, source.values, bytes);
+        return;
+    }
+    CheckDimensions(target, source.dimensions);
+    target.count += source.count;
+
+    if constexpr (IsSum(KIND)) {
+        VectorKernels::Add(reinterpret_cast<double*>(target.values), reinterpret_cast<const double*>(source.values),
+                           source.dimensions);
+    } else if constexpr (KIND == VectorAggregateKind::MIN) {
+        VectorKernels::Minimum(reinterpret_cast<float*>(target.values), reinterpret_cast<const float*>(source.values),
+                               source.dimensions);
+    } else {
+        VectorKernels::Maximum(reinterpret_cast<float*>(target.values), reinterpret_cast<const float*>(source.values),
+                               source.dimensions);
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Operation(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data,
+                                idx_t input_count, duckdb::Vector& states, idx_t count) {
+    const FloatVectorReader input(inputs[0], count);
+    duckdb::UnifiedVectorFormat states_format;
+    states.ToUnifiedFormat(count, states_format);
+    const auto state_pointers = duckdb::UnifiedVectorFormat::GetData<VectorAggregateState*>(states_format);
+
+    for (idx_t row = 0; row < count; row++) {
+        const float* data;
+        idx_t size;
+        if (input.Get(row, data, size)) {
+            Update<KIND>(*state_pointers[states_format.sel->get_index(row)], data, size, 1, aggr_input_data.allocator);
+        }
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data,
+                                   idx_t input_count, duckdb::data_ptr_t state_p, idx_t count) {
+    const FloatVectorReader input(inputs[0], count);
+    auto& state = *reinterpret_cast<VectorAggregateState*>(state_p);
+    const float* data;
+    idx_t size;
+
+    if (input.IsConstant()) {
+        if (input.Get(0, data, size)) {
+            Update<KIND>(state, data, size, static_cast<int64_t>(count), aggr_input_data.allocator);
+        }
+        return;
+    }
+    for (idx_t row = 0; row < count; row++) {
+        if (input.Get(row, data, size)) {
+            Update<KIND>(state, data, size, 1, aggr_input_data.allocator);
+        }
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Combine(duckdb::Vector& source, duckdb::Vector& target,
+                              duckdb::AggregateInputData& aggr_input_data, idx_t count) {
+    const auto source_states = duckdb::FlatVector::GetData<VectorAggregateState*>(source);
+    const auto target_states = duckdb::FlatVector::GetData<VectorAggregateState*>(target);
+    for (idx_t i = 0; i < count; i++) {
+        Merge<KIND>(*target_states[i], *source_states[i], aggr_input_data.allocator);
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Write(const VectorAggregateState& state, duckdb::Vector& result, const idx_t row) {
+    const auto size = state.dimensions;
+    idx_t offset;
+    if (result.GetType().id() == duckdb::LogicalTypeId::ARRAY) {
+        offset = row * size;
+    } else {
+        offset = duckdb::ListVector::GetListSize(result);
+        duckdb::ListVector::Reserve(result, offset + size);
+        duckdb::FlatVector::GetData<duckdb::list_entry_t>(result)[row] = duckdb::list_entry_t(offset, size);
+        duckdb::ListVector::SetListSize(result, offset + size);
+    }
+    auto& child = result.GetType().id() == duckdb::LogicalTypeId::ARRAY ? duckdb::ArrayVector::GetEntry(result)
+                                                                        : duckdb::ListVector::GetEntry(result);
+    const auto output = duckdb::FlatVector::GetData<float>(child) + offset;
+
+    if constexpr (!IsSum(KIND)) {
+        std::memcpy(output, state.values, size * sizeof(float));
+        return;
+    }
+    const auto sums = reinterpret_cast<const double*>(state.values);
+    auto scale = KIND == VectorAggregateKind::SUM ? 1.0 : 1.0 / static_cast<double>(state.count);
+    if constexpr (KIND == VectorAggregateKind::NORMALIZED_MEAN) {
+        // The mean of unit vectors is shorter than one unless they all agree, it is scaled back to unit length
+        double squared_norm = 0;
+        for (idx_t i = 0; i < size; i++) {
+            squared_norm += sums[i] * sums[i];
+        }
+        scale = squared_norm > 0 ? 1.0 / std::sqrt(squared_norm) : 1.0;
+    }
+    for (idx_t i = 0; i < size; i++) {
+        output[i] = static_cast<float>(sums[i] * scale);
+    }
+}
+
+template <VectorAggregateKind KIND>
+void VectorAggregate::Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data,
+                               duckdb::Vector& result, idx_t count, idx_t offset) {
+    if (states.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR) {
+        result.SetVectorType(duckdb::VectorType::CONSTANT_VECTOR);
+        const auto& state = **duckdb::ConstantVector::GetData<VectorAggregateState*>(states);
+        if (state.count == 0) {
+            duckdb::ConstantVector::SetNull(result, true);
+        } else {
+            Write<KIND>(state, result, 0);
+        }
+        return;
+    }
+
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    const auto state_pointers = duckdb::FlatVector::GetData<VectorAggregateState*>(states);
+    for (idx_t i = 0; i < count; i++) {
+        const auto row = i + offset;
+        if (state_pointers[i]->count == 0) {
+            duckdb::FlatVector::SetNull(result, row, true);
+        } else {
+            Write<KIND>(*state_pointers[i], result, row);
+        }
+    }
+}
+
+} // namespace flockmtl
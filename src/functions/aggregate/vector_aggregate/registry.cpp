@@ -0,0 +1,16 @@
+#include "flockmtl/functions/aggregate/vector_aggregate.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void AggregateRegistry::RegisterVectorAggregates(duckdb::DatabaseInstance& db) {
+    duckdb::ExtensionUtil::RegisterFunction(db, VectorAggregate::GetFunction("vector_sum", VectorAggregateKind::SUM));
+    duckdb::ExtensionUtil::RegisterFunction(db,
+                                            VectorAggregate::GetFunction("vector_mean", VectorAggregateKind::MEAN));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, VectorAggregate::GetFunction("vector_normalized_mean", VectorAggregateKind::NORMALIZED_MEAN));
+    duckdb::ExtensionUtil::RegisterFunction(db, VectorAggregate::GetFunction("vector_min", VectorAggregateKind::MIN));
+    duckdb::ExtensionUtil::RegisterFunction(db, VectorAggregate::GetFunction("vector_max", VectorAggregateKind::MAX));
+}
+
+} // namespace flockmtl
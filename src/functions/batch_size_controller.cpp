@@ -0,0 +1,69 @@
+#include "flockmtl/functions/batch_size_controller.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "flockmtl/model_manager/providers/provider.hpp"
+
+namespace flockmtl {
+
+std::mutex BatchSizeController::registry_mutex_;
+std::map<std::string, std::shared_ptr<BatchSizeController>> BatchSizeController::registry_;
+
+BatchSizeController::BatchSizeController(const int32_t max_output_tokens)
+    : max_output_tokens_(std::max(max_output_tokens, 1)), output_tokens_per_tuple_(0), batch_size_(0) {}
+
+std::shared_ptr<BatchSizeController> BatchSizeController::Get(const ModelDetails& model_details,
+                                                              const ScalarFunctionType function_type) {
+    const auto key = model_details.provider_name + "/" + model_details.model + "/" +
+                     std::to_string(model_details.max_output_tokens) + "/" +
+                     std::to_string(static_cast<int>(function_type));
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto& controller = registry_[key];
+    if (!controller) {
+        controller = std::make_shared<BatchSizeController>(model_details.max_output_tokens);
+    }
+    return controller;
+}
+
+size_t BatchSizeController::GetBatchSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_size_;
+}
+
+void BatchSizeController::RecordSuccess(const size_t batch_size, const int32_t output_tokens) {
+    if (batch_size == 0 || output_tokens <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto observed = static_cast<double>(output_tokens) / batch_size;
+    output_tokens_per_tuple_ = output_tokens_per_tuple_ == 0
+                                   ? observed
+                                   : smoothing_factor * observed + (1 - smoothing_factor) * output_tokens_per_tuple_;
+
+    const auto target = std::max<size_t>(
+        1, static_cast<size_t>(max_output_tokens_ * output_tokens_headroom / output_tokens_per_tuple_));
+    if (batch_size_ == 0 || target < batch_size_) {
+        batch_size_ = target;
+    } else {
+        // Grow at most twice as large per successful batch so a single short response cannot overshoot.
+        batch_size_ = std::min(target, std::max(batch_size_, batch_size) * 2);
+    }
+}
+
+void BatchSizeController::RecordOverflow(const size_t batch_size) {
+    if (batch_size <= 1) {
+        throw ExceededMaxOutputTokensError();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The batch overflowed, so each tuple needed more than this many output tokens on average.
+    output_tokens_per_tuple_ =
+        std::max(output_tokens_per_tuple_, static_cast<double>(max_output_tokens_) / static_cast<double>(batch_size));
+    const auto halved = batch_size / 2;
+    batch_size_ = batch_size_ == 0 ? halved : std::min(batch_size_, halved);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,182 @@
+#include "flockmtl/functions/scalar/fusion.hpp"
+#include "flockmtl/functions/aggregate/fusion_stats.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+
+#include <algorithm>
+
+namespace flockmtl {
+
+namespace {
+
+// Each operator folds the transformed scores of a row into an accumulator, then turns it into the fused score;
+// Finalize returns false when the fused score is NULL
+struct RelativeOperator {
+    static double Initial() { return 0; }
+    static double Transform(const double score) { return score; }
+    static void Combine(double& fused, const double score) { fused = std::max(fused, score); }
+    static bool Finalize(double&, uint32_t) { return true; }
+};
+
+struct CombSumOperator {
+    static double Initial() { return 0; }
+    static double Transform(const double score) { return score; }
+    static void Combine(double& fused, const double score) { fused += score; }
+    static bool Finalize(double&, const uint32_t hits) { return hits > 0; }
+};
+
+// CombSUM multiplied by the number of lists the row appears in, which favors rows found by several retrievers
+struct CombMnzOperator : CombSumOperator {
+    static bool Finalize(double& fused, const uint32_t hits) {
+        fused *= hits;
+        return hits > 0;
+    }
+};
+
+// The arguments are 1-based ranks rather than scores
+struct RrfOperator : CombSumOperator {
+    static double Transform(const double rank) { return 1.0 / (Fusion::rrf_k + rank); }
+};
+
+struct MinMaxOperator {
+    static double Operation(const double score, const double min, const double max, const double, const double) {
+        // All the scores are equal, so they are all equally relevant
+        return max > min ? (score - min) / (max - min) : 1.0;
+    }
+};
+
+struct ZScoreOperator {
+    static double Operation(const double score, const double, const double, const double mean, const double stddev) {
+        return stddev > 0 ? (score - mean) / stddev : 0.0;
+    }
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData>
+Fusion::BindWeighted(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                     duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    if (!arguments[0]->IsFoldable()) {
+        throw std::runtime_error(duckdb_fmt::format("{}: The weights must be a constant list.", bound_function.name));
+    }
+    const auto weights = duckdb::ExpressionExecutor::EvaluateScalar(context, *arguments[0]);
+    if (weights.IsNull() || duckdb::ListValue::GetChildren(weights).size() != arguments.size() - 1) {
+        throw std::runtime_error(duckdb_fmt::format("{}: Expected one weight per score, got {} scores.",
+                                                    bound_function.name, arguments.size() - 1));
+    }
+    return nullptr;
+}
+
+template <class OP>
+void Fusion::ExecuteFusion(duckdb::DataChunk& args, duckdb::Vector& result, const duckdb::idx_t first_score,
+                           const std::vector<double>& weights) {
+    const auto count = args.size();
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    auto fused = duckdb::FlatVector::GetData<double>(result);
+    auto& validity = duckdb::FlatVector::Validity(result);
+    uint32_t hits[STANDARD_VECTOR_SIZE];
+    std::fill_n(fused, count, OP::Initial());
+    std::fill_n(hits, count, 0);
+
+    // Scores are folded one column at a time, so each column is read sequentially and the loops have no branches
+    // when the column has no NULLs
+    for (auto column = first_score; column < args.ColumnCount(); column++) {
+        duckdb::UnifiedVectorFormat format;
+        args.data[column].ToUnifiedFormat(count, format);
+        const auto scores = duckdb::UnifiedVectorFormat::GetData<double>(format);
+        const auto weight = weights.empty() ? 1.0 : weights[column - first_score];
+
+        if (format.validity.AllValid()) {
+            for (duckdb::idx_t row = 0; row < count; row++) {
+                OP::Combine(fused[row], weight * OP::Transform(scores[format.sel->get_index(row)]));
+            }
+            for (duckdb::idx_t row = 0; row < count; row++) {
+                hits[row]++;
+            }
+            continue;
+        }
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            const auto index = format.sel->get_index(row);
+            if (format.validity.RowIsValid(index)) {
+                OP::Combine(fused[row], weight * OP::Transform(scores[index]));
+                hits[row]++;
+            }
+        }
+    }
+
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        if (!OP::Finalize(fused[row], hits[row])) {
+            validity.SetInvalid(row);
+        }
+    }
+}
+
+template <class OP>
+void Fusion::ExecuteNormalize(duckdb::DataChunk& args, duckdb::Vector& result) {
+    const auto count = args.size();
+    duckdb::UnifiedVectorFormat score_format;
+    args.data[0].ToUnifiedFormat(count, score_format);
+    const auto scores = duckdb::UnifiedVectorFormat::GetData<double>(score_format);
+
+    // The statistics usually come from `fusion_stats(score) OVER ()`, a constant for the whole chunk
+    auto& stats = args.data[1];
+    const auto constant_stats = stats.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR;
+    if (!constant_stats) {
+        stats.Flatten(count);
+    }
+    const auto& fields = duckdb::StructVector::GetEntries(stats);
+    const auto min = duckdb::FlatVector::GetData<double>(*fields[FusionStats::MIN]);
+    const auto max = duckdb::FlatVector::GetData<double>(*fields[FusionStats::MAX]);
+    const auto mean = duckdb::FlatVector::GetData<double>(*fields[FusionStats::MEAN]);
+    const auto stddev = duckdb::FlatVector::GetData<double>(*fields[FusionStats::STDDEV]);
+
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    auto result_data = duckdb::FlatVector::GetData<double>(result);
+    auto& validity = duckdb::FlatVector::Validity(result);
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const auto score_index = score_format.sel->get_index(row);
+        const auto stats_row = constant_stats ? 0 : row;
+        const auto stats_valid = constant_stats ? !duckdb::ConstantVector::IsNull(stats)
+                                                : duckdb::FlatVector::Validity(stats).RowIsValid(row);
+        if (!score_format.validity.RowIsValid(score_index) || !stats_valid) {
+            validity.SetInvalid(row);
+            continue;
+        }
+        result_data[row] = OP::Operation(scores[score_index], min[stats_row], max[stats_row], mean[stats_row],
+                                         stddev[stats_row]);
+    }
+}
+
+void Fusion::ExecuteRelative(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteFusion<RelativeOperator>(args, result, 0, {});
+}
+
+void Fusion::ExecuteRrf(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteFusion<RrfOperator>(args, result, 0, {});
+}
+
+void Fusion::ExecuteCombSum(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteFusion<CombSumOperator>(args, result, 0, {});
+}
+
+void Fusion::ExecuteCombMnz(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteFusion<CombMnzOperator>(args, result, 0, {});
+}
+
+void Fusion::ExecuteWeighted(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    // The weights are a constant checked while binding, so they are read once per chunk
+    std::vector<double> weights;
+    for (const auto& weight : duckdb::ListValue::GetChildren(args.data[0].GetValue(0))) {
+        weights.push_back(weight.IsNull() ? 0.0 : weight.GetValue<double>());
+    }
+    ExecuteFusion<CombSumOperator>(args, result, 1, weights);
+}
+
+void Fusion::ExecuteMinMax(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteNormalize<MinMaxOperator>(args, result);
+}
+
+void Fusion::ExecuteZScore(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    ExecuteNormalize<ZScoreOperator>(args, result);
+}
+
+} // namespace flockmtl
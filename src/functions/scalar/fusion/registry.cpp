@@ -0,0 +1,32 @@
+#include "flockmtl/functions/scalar/fusion.hpp"
+#include "flockmtl/functions/aggregate/fusion_stats.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void ScalarRegistry::RegisterFusion(duckdb::DatabaseInstance& db) {
+    const auto register_fusion = [&](const std::string& name, const duckdb::scalar_function_t& function) {
+        duckdb::ExtensionUtil::RegisterFunction(
+            db, duckdb::ScalarFunction(name, {}, duckdb::LogicalType::DOUBLE, function, nullptr, nullptr, nullptr,
+                                       nullptr, duckdb::LogicalType::DOUBLE));
+    };
+    register_fusion("fusion_relative", Fusion::ExecuteRelative);
+    register_fusion("fusion_rrf", Fusion::ExecuteRrf);
+    register_fusion("fusion_combsum", Fusion::ExecuteCombSum);
+    register_fusion("fusion_combmnz", Fusion::ExecuteCombMnz);
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("fusion_weighted", {duckdb::LogicalType::LIST(duckdb::LogicalType::DOUBLE)},
+                                   duckdb::LogicalType::DOUBLE, Fusion::ExecuteWeighted, Fusion::BindWeighted,
+                                   nullptr, nullptr, nullptr, duckdb::LogicalType::DOUBLE));
+
+    const duckdb::vector<duckdb::LogicalType> normalize_arguments = {duckdb::LogicalType::DOUBLE,
+                                                                     FusionStats::GetResultType()};
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("fusion_minmax", normalize_arguments, duckdb::LogicalType::DOUBLE,
+                                   Fusion::ExecuteMinMax));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("fusion_zscore", normalize_arguments, duckdb::LogicalType::DOUBLE,
+                                   Fusion::ExecuteZScore));
+}
+
+} // namespace flockmtl
@@ -26,6 +26,7 @@ std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args) {
 
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
     Model model(model_details_json);
+    RejectOfflineExecution(model, "llm_complete");
     auto prompt_details_json = CastVectorOfStructsToJson(args.data[1], 1)[0];
     auto prompt_details = PromptManager::CreatePromptDetails(prompt_details_json);
 
@@ -49,7 +50,7 @@ std::vector<std::string> LlmComplete::Operation(duckdb::DataChunk& args) {
 }
 
 void LlmComplete::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
-
+    RequestScheduler::OriginScope origin(state.GetContext());
     auto results = LlmComplete::Operation(args);
 
     auto index = 0;
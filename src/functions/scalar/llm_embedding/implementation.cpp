@@ -1,4 +1,5 @@
 #include "flockmtl/functions/scalar/llm_embedding.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 
 namespace flockmtl {
 
@@ -14,12 +15,50 @@ void LlmEmbedding::ValidateArguments(duckdb::DataChunk& args) {
     }
 }
 
-std::vector<duckdb::vector<duckdb::Value>> LlmEmbedding::Operation(duckdb::DataChunk& args) {
+duckdb::unique_ptr<duckdb::FunctionData>
+LlmEmbedding::Bind(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                   duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    if (arguments.empty() || arguments[0]->return_type.id() != duckdb::LogicalTypeId::STRUCT ||
+        !arguments[0]->IsFoldable()) {
+        return nullptr;
+    }
+
+    duckdb::Vector model_vector(duckdb::ExpressionExecutor::EvaluateScalar(context, *arguments[0]));
+    auto model_details_json = CastVectorOfStructsToJson(model_vector, 1)[0];
+    if (!model_details_json.contains("output_type")) {
+        return nullptr;
+    }
+    const auto output_type = duckdb::StringUtil::Lower(model_details_json["output_type"].get<std::string>());
+    if (output_type == "list") {
+        return nullptr;
+    }
+    if (output_type != "array") {
+        throw std::runtime_error("LlmEmbedScalarParser: output_type must be either 'list' or 'array'.");
+    }
+
+    // The array size is part of the return type, so the model has to be resolved while binding
+    Model model(model_details_json);
+    const auto dimensions = model.GetModelDetails().dimensions;
+    if (dimensions <= 0) {
+        throw std::runtime_error(
+            "LlmEmbedScalarParser: The embedding size of the model is unknown, set 'dimensions' to use the 'array' "
+            "output_type.");
+    }
+    bound_function.return_type = duckdb::LogicalType::ARRAY(duckdb::LogicalType::FLOAT, dimensions);
+    return nullptr;
+}
+
+std::vector<std::vector<float>> LlmEmbedding::Operation(duckdb::DataChunk& args) {
     LlmEmbedding::ValidateArguments(args);
 
     auto inputs = CastVectorOfStructsToJson(args.data[1], args.size());
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
     Model model(model_details_json);
+    // Only one chunk is seen at a time, so offline execution would wait for one batch job per chunk in turn
+    if (model.GetModelDetails().offline_execution) {
+        throw std::runtime_error("llm_embedding does not support the `offline` execution_mode, it would submit and "
+                                 "wait for one batch job per chunk; use the `online` execution_mode.");
+    }
 
     std::vector<std::string> prepared_inputs;
     for (auto& row : inputs) {
@@ -30,25 +69,46 @@ std::vector<duckdb::vector<duckdb::Value>> LlmEmbedding::Operation(duckdb::DataC
         prepared_inputs.push_back(concat_input);
     }
 
-    auto embeddings = model.CallEmbedding(prepared_inputs);
-    std::vector<duckdb::vector<duckdb::Value>> results;
-    for (size_t index = 0; index < embeddings.size(); index++) {
-        duckdb::vector<duckdb::Value> embedding;
-        for (auto& value : embeddings[index]) {
-            embedding.push_back(duckdb::Value(static_cast<double>(value)));
-        }
-        results.push_back(embedding);
-    }
-    return results;
+    // The chunk is split to fit the provider's per request limits, and the sub-batches are sent concurrently
+    return EmbeddingBatcher::Run(
+        prepared_inputs, model.GetEmbeddingBatchLimits(),
+        [&model](const std::vector<std::string>& batch_inputs) { return model.CallEmbedding(batch_inputs); });
 }
 
 void LlmEmbedding::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
-    auto results = LlmEmbedding::Operation(args);
+    RequestScheduler::OriginScope origin(state.GetContext());
+    const auto embeddings = LlmEmbedding::Operation(args);
 
-    auto index = 0;
-    for (const auto& res : results) {
-        result.SetValue(index++, duckdb::Value::LIST(res));
+    // The embeddings are copied straight into the child buffer instead of going through a Value per dimension
+    if (result.GetType().id() == duckdb::LogicalTypeId::ARRAY) {
+        const auto dimensions = duckdb::ArrayType::GetSize(result.GetType());
+        auto child_data = duckdb::FlatVector::GetData<float>(duckdb::ArrayVector::GetEntry(result));
+        for (size_t row = 0; row < embeddings.size(); row++) {
+            if (embeddings[row].size() != dimensions) {
+                throw std::runtime_error(duckdb_fmt::format(
+                    "LlmEmbedScalarParser: Expected embeddings of size {}, the model returned {}; set 'dimensions' to "
+                    "match the model.",
+                    dimensions, embeddings[row].size()));
+            }
+            std::memcpy(child_data + row * dimensions, embeddings[row].data(), dimensions * sizeof(float));
+        }
+        return;
+    }
+
+    size_t total_size = 0;
+    for (const auto& embedding : embeddings) {
+        total_size += embedding.size();
+    }
+    duckdb::ListVector::Reserve(result, total_size);
+    auto list_entries = duckdb::FlatVector::GetData<duckdb::list_entry_t>(result);
+    auto child_data = duckdb::FlatVector::GetData<double>(duckdb::ListVector::GetEntry(result));
+    size_t offset = 0;
+    for (size_t row = 0; row < embeddings.size(); row++) {
+        list_entries[row] = duckdb::list_entry_t(offset, embeddings[row].size());
+        std::copy(embeddings[row].begin(), embeddings[row].end(), child_data + offset);
+        offset += embeddings[row].size();
     }
+    duckdb::ListVector::SetListSize(result, offset);
 }
 
 } // namespace flockmtl
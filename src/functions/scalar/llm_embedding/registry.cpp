@@ -7,7 +7,8 @@ void ScalarRegistry::RegisterLlmEmbedding(duckdb::DatabaseInstance& db) {
     duckdb::ExtensionUtil::RegisterFunction(
         db,
         duckdb::ScalarFunction("llm_embedding", {}, duckdb::LogicalType::LIST(duckdb::LogicalType::DOUBLE),
-                               LlmEmbedding::Execute, nullptr, nullptr, nullptr, nullptr, duckdb::LogicalType::ANY));
+                               LlmEmbedding::Execute, LlmEmbedding::Bind, nullptr, nullptr, nullptr,
+                               duckdb::LogicalType::ANY));
 }
 
 } // namespace flockmtl
@@ -26,6 +26,7 @@ std::vector<std::string> LlmFilter::Operation(duckdb::DataChunk& args) {
 
     auto model_details_json = CastVectorOfStructsToJson(args.data[0], 1)[0];
     Model model(model_details_json);
+    RejectOfflineExecution(model, "llm_filter");
     auto prompt_details_json = CastVectorOfStructsToJson(args.data[1], 1)[0];
     auto prompt_details = PromptManager::CreatePromptDetails(prompt_details_json);
 
@@ -44,6 +45,7 @@ std::vector<std::string> LlmFilter::Operation(duckdb::DataChunk& args) {
 }
 
 void LlmFilter::Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result) {
+    RequestScheduler::OriginScope origin(state.GetContext());
     auto results = LlmFilter::Operation(args);
 
     auto index = 0;
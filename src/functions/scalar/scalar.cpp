@@ -10,9 +10,22 @@ nlohmann::json ScalarFunctionBase::Complete(const nlohmann::json& tuples, const
     return response["tuples"];
 };
 
-nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::json>& tuples,
-                                                    const std::string& user_prompt,
-                                                    const ScalarFunctionType function_type, Model& model) {
+void ScalarFunctionBase::CompleteStream(const nlohmann::json& tuples, const std::string& user_prompt,
+                                        const ScalarFunctionType function_type, Model& model,
+                                        nlohmann::json& responses) {
+    const auto prompt = PromptManager::Render(user_prompt, tuples, function_type);
+    size_t num_tuples = 0;
+    model.CallCompleteStream(prompt, [&](nlohmann::json tuple) {
+        if (++num_tuples > tuples.size()) {
+            throw std::runtime_error(duckdb_fmt::format("The model returned more than the {} requested tuples",
+                                                        tuples.size()));
+        }
+        responses.push_back(std::move(tuple));
+    });
+}
+
+int ScalarFunctionBase::GetAvailableTokens(const std::string& user_prompt, const ScalarFunctionType function_type,
+                                           Model& model) {
     const auto llm_template = PromptManager::GetTemplate(function_type);
 
     int num_tokens_meta_and_user_prompt = 0;
@@ -20,54 +33,152 @@ nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::
     num_tokens_meta_and_user_prompt += Tiktoken::GetNumTokens(llm_template);
     const int available_tokens = model.GetModelDetails().context_window - num_tokens_meta_and_user_prompt;
 
-    auto responses = nlohmann::json::array();
-
     if (available_tokens < 0) {
         throw std::runtime_error("The total number of tokens in the prompt exceeds the model's maximum token limit");
-    } else {
-
-        auto accumulated_tuples_tokens = 0u;
-        auto batch_tuples = nlohmann::json::array();
-        auto batch_size = tuples.size();
-        int start_index = 0;
-
-        do {
-            accumulated_tuples_tokens +=
-                Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownHeader(tuples[start_index]));
-            while (accumulated_tuples_tokens < available_tokens && start_index < tuples.size() &&
-                   batch_tuples.size() < batch_size) {
-                auto num_tokens =
-                    Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownSingleTuple(tuples[start_index]));
-                if (accumulated_tuples_tokens + num_tokens > available_tokens) {
-                    break;
-                }
-                batch_tuples.push_back(tuples[start_index]);
-                accumulated_tuples_tokens += num_tokens;
-                start_index++;
-            }
+    }
+    return available_tokens;
+}
+
+void ScalarFunctionBase::RejectOfflineExecution(Model& model, const std::string& function_name) {
+    if (model.GetModelDetails().offline_execution) {
+        throw std::runtime_error(duckdb_fmt::format(
+            "{} does not support the `offline` execution_mode, it would submit and wait for one batch job per chunk; "
+            "use llm_map to complete the whole query in a single batch job.",
+            function_name));
+    }
+}
+
+size_t ScalarFunctionBase::GetBatchEnd(const std::vector<nlohmann::json>& tuples, const size_t start_index,
+                                       const size_t batch_size, const int available_tokens) {
+    auto accumulated_tuples_tokens =
+        Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownHeader(tuples[start_index]));
+    auto end_index = start_index;
+    while (end_index < tuples.size() && (batch_size == 0 || end_index - start_index < batch_size)) {
+        auto num_tokens = Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownSingleTuple(tuples[end_index]));
+        if (accumulated_tuples_tokens + num_tokens > available_tokens) {
+            break;
+        }
+        accumulated_tuples_tokens += num_tokens;
+        end_index++;
+    }
+
+    if (end_index == start_index) {
+        throw std::runtime_error("A single tuple exceeds the model's available context window");
+    }
+    return end_index;
+}
+
+nlohmann::json ScalarFunctionBase::BatchAndComplete(const std::vector<nlohmann::json>& tuples,
+                                                    const std::string& user_prompt,
+                                                    const ScalarFunctionType function_type, Model& model) {
+    if (model.GetModelDetails().offline_execution) {
+        return BatchAndCompleteOffline(tuples, user_prompt, function_type, model);
+    }
+    return BatchAndCompleteOnline(tuples, user_prompt, function_type, model);
+}
+
+nlohmann::json ScalarFunctionBase::BatchAndCompleteOnline(const std::vector<nlohmann::json>& tuples,
+                                                          const std::string& user_prompt,
+                                                          const ScalarFunctionType function_type, Model& model) {
+    const int available_tokens = GetAvailableTokens(user_prompt, function_type, model);
+    auto controller = BatchSizeController::Get(model.GetModelDetails(), function_type);
+    auto responses = nlohmann::json::array();
+    size_t start_index = 0;
 
-            nlohmann::json response;
+    while (start_index < tuples.size()) {
+        const auto end_index = GetBatchEnd(tuples, start_index, controller->GetBatchSize(), available_tokens);
+        const auto batch_size = end_index - start_index;
+        const auto batch_tuples = nlohmann::json(std::vector<nlohmann::json>(
+            tuples.begin() + static_cast<std::ptrdiff_t>(start_index),
+            tuples.begin() + static_cast<std::ptrdiff_t>(end_index)));
+
+        if (model.GetModelDetails().stream) {
+            const auto num_responses = responses.size();
             try {
-                response = Complete(batch_tuples, user_prompt, function_type, model);
+                CompleteStream(batch_tuples, user_prompt, function_type, model, responses);
             } catch (const ExceededMaxOutputTokensError&) {
-                batch_tuples.clear();
-                const auto new_batch_size = static_cast<int>(batch_size * 0.1);
-                batch_size = batch_size == 1 ? new_batch_size == 0 : new_batch_size;
-                accumulated_tuples_tokens = 0;
-                start_index = 0;
+                // The tuples completed before the limit was hit are kept, only the remaining ones are retried
+                controller->RecordOverflow(batch_size);
+                start_index += responses.size() - num_responses;
                 continue;
             }
-            auto output_tokens_per_tuple = Tiktoken::GetNumTokens(response.dump()) / batch_tuples.size();
-
-            batch_size = model.GetModelDetails().max_output_tokens / output_tokens_per_tuple;
-            batch_tuples.clear();
-            accumulated_tuples_tokens = 0;
 
-            for (const auto& tuple : response) {
-                responses.push_back(tuple);
+            auto output_tokens = model.GetLastUsage().completion_tokens;
+            if (output_tokens <= 0) {
+                for (auto i = num_responses; i < responses.size(); i++) {
+                    output_tokens += Tiktoken::GetNumTokens(responses[i].dump());
+                }
             }
+            controller->RecordSuccess(batch_size, output_tokens);
+            start_index = end_index;
+            continue;
+        }
+
+        nlohmann::json response;
+        try {
+            response = Complete(batch_tuples, user_prompt, function_type, model);
+        } catch (const ExceededMaxOutputTokensError&) {
+            // Only the failing batch is retried, with half as many tuples; earlier batches are kept.
+            controller->RecordOverflow(batch_size);
+            continue;
+        }
+
+        auto output_tokens = model.GetLastUsage().completion_tokens;
+        if (output_tokens <= 0) {
+            output_tokens = Tiktoken::GetNumTokens(response.dump());
+        }
+        controller->RecordSuccess(batch_size, output_tokens);
+        start_index = end_index;
+
+        for (const auto& tuple : response) {
+            responses.push_back(tuple);
+        }
+    }
+
+    return responses;
+}
+
+nlohmann::json ScalarFunctionBase::BatchAndCompleteOffline(const std::vector<nlohmann::json>& tuples,
+                                                           const std::string& user_prompt,
+                                                           const ScalarFunctionType function_type, Model& model) {
+    const int available_tokens = GetAvailableTokens(user_prompt, function_type, model);
+    auto controller = BatchSizeController::Get(model.GetModelDetails(), function_type);
+    const auto batch_size = static_cast<size_t>(
+        std::max(1, model.GetModelDetails().max_output_tokens / offline_output_tokens_per_tuple));
+
+    // All the batches go into a single offline job, so the whole input is split upfront
+    std::vector<std::pair<size_t, size_t>> batches;
+    std::vector<std::string> prompts;
+    for (size_t start_index = 0; start_index < tuples.size();) {
+        const auto end_index = GetBatchEnd(tuples, start_index, batch_size, available_tokens);
+        const auto batch_tuples = nlohmann::json(std::vector<nlohmann::json>(
+            tuples.begin() + static_cast<std::ptrdiff_t>(start_index),
+            tuples.begin() + static_cast<std::ptrdiff_t>(end_index)));
+        prompts.push_back(PromptManager::Render(user_prompt, batch_tuples, function_type));
+        batches.emplace_back(start_index, end_index);
+        start_index = end_index;
+    }
+
+    const auto completions = model.CallCompleteOffline(prompts);
+
+    auto responses = nlohmann::json::array();
+    for (size_t i = 0; i < batches.size(); i++) {
+        const auto [start_index, end_index] = batches[i];
+        nlohmann::json response;
+        if (completions[i].is_null()) {
+            // The batch overflowed max_output_tokens, its tuples are completed online in smaller batches
+            controller->RecordOverflow(end_index - start_index);
+            response = BatchAndCompleteOnline(
+                std::vector<nlohmann::json>(tuples.begin() + static_cast<std::ptrdiff_t>(start_index),
+                                            tuples.begin() + static_cast<std::ptrdiff_t>(end_index)),
+                user_prompt, function_type, model);
+        } else {
+            response = completions[i]["tuples"];
+        }
 
-        } while (start_index < tuples.size());
+        for (const auto& tuple : response) {
+            responses.push_back(tuple);
+        }
     }
 
     return responses;
@@ -0,0 +1,163 @@
+#include "flockmtl/functions/scalar/vector_quantization.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorQuantization::BindQuantizeInt8(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                                     duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    bound_function.arguments[0] = FloatVectorReader::GetCastType(arguments[0]->return_type, bound_function.name);
+    bound_function.return_type = Int8VectorReader::GetCastType(arguments[0]->return_type, bound_function.name);
+    return nullptr;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorQuantization::BindQuantizeBinary(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                                       duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    bound_function.arguments[0] = FloatVectorReader::GetCastType(arguments[0]->return_type, bound_function.name);
+    return nullptr;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorQuantization::BindInt8Metric(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                                   duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    for (size_t i = 0; i < arguments.size(); i++) {
+        bound_function.arguments[i] = Int8VectorReader::GetCastType(arguments[i]->return_type, bound_function.name);
+    }
+    return nullptr;
+}
+
+void VectorQuantization::ExecuteQuantizeInt8(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                             duckdb::Vector& result) {
+    const FloatVectorReader input(args.data[0], args.size());
+    const auto count = input.IsConstant() ? 1 : args.size();
+    result.SetVectorType(input.IsConstant() ? duckdb::VectorType::CONSTANT_VECTOR : duckdb::VectorType::FLAT_VECTOR);
+    const auto is_array = result.GetType().id() == duckdb::LogicalTypeId::ARRAY;
+
+    duckdb::list_entry_t* list_entries = nullptr;
+    if (!is_array) {
+        duckdb::idx_t total_size = 0;
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            const float* data;
+            duckdb::idx_t size;
+            if (input.Get(row, data, size)) {
+                total_size += size;
+            }
+        }
+        duckdb::ListVector::Reserve(result, total_size);
+        list_entries = duckdb::ConstantVector::GetData<duckdb::list_entry_t>(result);
+    }
+    auto& child = is_array ? duckdb::ArrayVector::GetEntry(result) : duckdb::ListVector::GetEntry(result);
+    auto child_data = duckdb::FlatVector::GetData<int8_t>(child);
+
+    duckdb::idx_t offset = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const float* data;
+        duckdb::idx_t size;
+        if (!input.Get(row, data, size)) {
+            if (input.IsConstant()) {
+                duckdb::ConstantVector::SetNull(result, true);
+            } else {
+                duckdb::FlatVector::SetNull(result, row, true);
+            }
+            continue;
+        }
+        if (is_array) {
+            offset = row * size;
+        }
+        Quantizer::QuantizeInt8(data, size, child_data + offset);
+        if (!is_array) {
+            list_entries[row] = {offset, size};
+            offset += size;
+        }
+    }
+    if (!is_array) {
+        duckdb::ListVector::SetListSize(result, offset);
+    }
+}
+
+void VectorQuantization::ExecuteQuantizeBinary(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                               duckdb::Vector& result) {
+    const FloatVectorReader input(args.data[0], args.size());
+    const auto count = input.IsConstant() ? 1 : args.size();
+    result.SetVectorType(input.IsConstant() ? duckdb::VectorType::CONSTANT_VECTOR : duckdb::VectorType::FLAT_VECTOR);
+    auto result_data = duckdb::FlatVector::GetData<duckdb::string_t>(result);
+
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const float* data;
+        duckdb::idx_t size;
+        if (!input.Get(row, data, size)) {
+            if (input.IsConstant()) {
+                duckdb::ConstantVector::SetNull(result, true);
+            } else {
+                duckdb::FlatVector::SetNull(result, row, true);
+            }
+            continue;
+        }
+        auto blob = duckdb::StringVector::EmptyString(result, Quantizer::GetBinarySize(size));
+        Quantizer::QuantizeBinary(data, size, reinterpret_cast<uint8_t*>(blob.GetDataWriteable()));
+        blob.Finalize();
+        result_data[row] = blob;
+    }
+}
+
+template <class RESULT_TYPE, class OP>
+void VectorQuantization::ExecuteInt8Metric(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                           duckdb::Vector& result, OP&& operation) {
+    const auto& function_name = state.expr.Cast<duckdb::BoundFunctionExpression>().function.name;
+    const Int8VectorReader left(args.data[0], args.size());
+    const Int8VectorReader right(args.data[1], args.size());
+    const auto is_constant = left.IsConstant() && right.IsConstant();
+    const auto count = is_constant ? 1 : args.size();
+    result.SetVectorType(is_constant ? duckdb::VectorType::CONSTANT_VECTOR : duckdb::VectorType::FLAT_VECTOR);
+    auto result_data = duckdb::FlatVector::GetData<RESULT_TYPE>(result);
+
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const int8_t *left_data, *right_data;
+        duckdb::idx_t left_size, right_size;
+        if (!left.Get(row, left_data, left_size) || !right.Get(row, right_data, right_size)) {
+            if (is_constant) {
+                duckdb::ConstantVector::SetNull(result, true);
+            } else {
+                duckdb::FlatVector::SetNull(result, row, true);
+            }
+            continue;
+        }
+        if (left_size != right_size) {
+            throw std::runtime_error(duckdb_fmt::format("{}: Vectors must have the same dimensions, got {} and {}.",
+                                                        function_name, left_size, right_size));
+        }
+        result_data[row] = operation(left_data, right_data, left_size);
+    }
+}
+
+void VectorQuantization::ExecuteInt8InnerProduct(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                                 duckdb::Vector& result) {
+    ExecuteInt8Metric<int32_t>(args, state, result, VectorKernels::Int8InnerProduct);
+}
+
+void VectorQuantization::ExecuteInt8CosineSimilarity(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                                     duckdb::Vector& result) {
+    ExecuteInt8Metric<double>(args, state, result, Quantizer::Int8CosineSimilarity);
+}
+
+void VectorQuantization::ExecuteHammingDistance(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                                duckdb::Vector& result) {
+    const auto& function_name = state.expr.Cast<duckdb::BoundFunctionExpression>().function.name;
+    duckdb::BinaryExecutor::Execute<duckdb::string_t, duckdb::string_t, int32_t>(
+        args.data[0], args.data[1], result, args.size(),
+        [&](const duckdb::string_t left, const duckdb::string_t right) {
+            if (left.GetSize() != right.GetSize()) {
+                throw std::runtime_error(
+                    duckdb_fmt::format("{}: Binary codes must have the same size, got {} and {} bytes.",
+                                       function_name, left.GetSize(), right.GetSize()));
+            }
+            return static_cast<int32_t>(VectorKernels::HammingDistance(
+                reinterpret_cast<const uint8_t*>(left.GetData()), reinterpret_cast<const uint8_t*>(right.GetData()),
+                left.GetSize()));
+        });
+}
+
+} // namespace flockmtl
@@ -0,0 +1,28 @@
+#include "flockmtl/functions/scalar/vector_quantization.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void ScalarRegistry::RegisterVectorQuantization(duckdb::DatabaseInstance& db) {
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_quantize_int8", {duckdb::LogicalType::ANY},
+                                   duckdb::LogicalType::LIST(duckdb::LogicalType::TINYINT),
+                                   VectorQuantization::ExecuteQuantizeInt8, VectorQuantization::BindQuantizeInt8));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_quantize_binary", {duckdb::LogicalType::ANY}, duckdb::LogicalType::BLOB,
+                                   VectorQuantization::ExecuteQuantizeBinary, VectorQuantization::BindQuantizeBinary));
+
+    const duckdb::vector<duckdb::LogicalType> int8_arguments = {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY};
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_int8_inner_product", int8_arguments, duckdb::LogicalType::INTEGER,
+                                   VectorQuantization::ExecuteInt8InnerProduct, VectorQuantization::BindInt8Metric));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_int8_cosine_similarity", int8_arguments, duckdb::LogicalType::DOUBLE,
+                                   VectorQuantization::ExecuteInt8CosineSimilarity,
+                                   VectorQuantization::BindInt8Metric));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_hamming_distance", {duckdb::LogicalType::BLOB, duckdb::LogicalType::BLOB},
+                                   duckdb::LogicalType::INTEGER, VectorQuantization::ExecuteHammingDistance));
+}
+
+} // namespace flockmtl
@@ -0,0 +1,277 @@
+#include "flockmtl/functions/scalar/vector_similarity.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace flockmtl {
+
+namespace {
+
+// Each operator can prepare a state from a constant side once, before scoring the rows of the chunk against it
+struct InnerProductOperator {
+    struct State {};
+    static State Prepare(const float*, duckdb::idx_t) { return {}; }
+    static double Operation(const State&, const float* query, const float* data, const duckdb::idx_t size) {
+        return VectorKernels::InnerProduct(query, data, size);
+    }
+};
+
+struct CosineSimilarityOperator {
+    struct State {
+        float squared_norm;
+    };
+    static State Prepare(const float* query, const duckdb::idx_t size) {
+        return {VectorKernels::SquaredNorm(query, size)};
+    }
+    static double Operation(const State& state, const float* query, const float* data, const duckdb::idx_t size) {
+        const auto norms = std::sqrt(static_cast<double>(state.squared_norm) *
+                                     static_cast<double>(VectorKernels::SquaredNorm(data, size)));
+        if (norms == 0) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return VectorKernels::InnerProduct(query, data, size) / norms;
+    }
+};
+
+struct L2DistanceOperator {
+    struct State {};
+    static State Prepare(const float*, duckdb::idx_t) { return {}; }
+    static double Operation(const State&, const float* query, const float* data, const duckdb::idx_t size) {
+        return std::sqrt(static_cast<double>(VectorKernels::L2SquaredDistance(query, data, size)));
+    }
+};
+
+struct L1DistanceOperator {
+    struct State {};
+    static State Prepare(const float*, duckdb::idx_t) { return {}; }
+    static double Operation(const State&, const float* query, const float* data, const duckdb::idx_t size) {
+        return VectorKernels::L1Distance(query, data, size);
+    }
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorSimilarity::Bind(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                       duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    // Both sides are cast to float32, so the kernels only ever see contiguous float buffers
+    for (size_t i = 0; i < arguments.size(); i++) {
+        bound_function.arguments[i] = FloatVectorReader::GetCastType(arguments[i]->return_type, bound_function.name);
+    }
+    const auto& left = bound_function.arguments[0];
+    const auto& right = bound_function.arguments[1];
+    if (left.id() == duckdb::LogicalTypeId::ARRAY && right.id() == duckdb::LogicalTypeId::ARRAY) {
+        CheckDimensions(bound_function.name, duckdb::ArrayType::GetSize(left), duckdb::ArrayType::GetSize(right));
+    }
+    return nullptr;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorSimilarity::BindNormalize(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                                duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    bound_function.arguments[0] = FloatVectorReader::GetCastType(arguments[0]->return_type, bound_function.name);
+    bound_function.return_type = bound_function.arguments[0];
+    return nullptr;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorSimilarity::BindTruncate(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                               duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments) {
+    // The size is part of the return type of arrays, so it has to be known while binding
+    if (!arguments[1]->IsFoldable()) {
+        throw std::runtime_error(
+            duckdb_fmt::format("{}: The number of dimensions must be a constant.", bound_function.name));
+    }
+    const auto size_value = duckdb::ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+    if (size_value.IsNull() || size_value.GetValue<int32_t>() <= 0) {
+        throw std::runtime_error(
+            duckdb_fmt::format("{}: The number of dimensions must be a positive number.", bound_function.name));
+    }
+    const auto size = static_cast<duckdb::idx_t>(size_value.GetValue<int32_t>());
+
+    bound_function.arguments[0] = FloatVectorReader::GetCastType(arguments[0]->return_type, bound_function.name);
+    const auto& input_type = bound_function.arguments[0];
+    if (input_type.id() == duckdb::LogicalTypeId::ARRAY) {
+        if (duckdb::ArrayType::GetSize(input_type) < size) {
+            throw std::runtime_error(duckdb_fmt::format("{}: Cannot truncate vectors of {} dimensions to {}.",
+                                                        bound_function.name, duckdb::ArrayType::GetSize(input_type),
+                                                        size));
+        }
+        bound_function.return_type = duckdb::LogicalType::ARRAY(duckdb::LogicalType::FLOAT, size);
+    } else {
+        bound_function.return_type = input_type;
+    }
+    return nullptr;
+}
+
+void VectorSimilarity::CheckDimensions(const std::string& function_name, const duckdb::idx_t left_size,
+                                       const duckdb::idx_t right_size) {
+    if (left_size != right_size) {
+        throw std::runtime_error(duckdb_fmt::format("{}: Vectors must have the same dimensions, got {} and {}.",
+                                                    function_name, left_size, right_size));
+    }
+}
+
+template <class OP>
+void VectorSimilarity::ExecuteMetric(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                     duckdb::Vector& result) {
+    const auto& function_name = state.expr.Cast<duckdb::BoundFunctionExpression>().function.name;
+    const auto count = args.size();
+    const FloatVectorReader left(args.data[0], count);
+    const FloatVectorReader right(args.data[1], count);
+
+    if (left.IsConstant() && right.IsConstant()) {
+        result.SetVectorType(duckdb::VectorType::CONSTANT_VECTOR);
+        const float *left_data, *right_data;
+        duckdb::idx_t left_size, right_size;
+        if (!left.Get(0, left_data, left_size) || !right.Get(0, right_data, right_size)) {
+            duckdb::ConstantVector::SetNull(result, true);
+            return;
+        }
+        CheckDimensions(function_name, left_size, right_size);
+        duckdb::ConstantVector::GetData<double>(result)[0] =
+            OP::Operation(OP::Prepare(left_data, left_size), left_data, right_data, left_size);
+        return;
+    }
+
+    result.SetVectorType(duckdb::VectorType::FLAT_VECTOR);
+    auto result_data = duckdb::FlatVector::GetData<double>(result);
+
+    // A constant side is usually the query vector: it is resolved and prepared once for the whole chunk. All the
+    // metrics are symmetric, so the query can be passed first whichever side it came from.
+    if (left.IsConstant() || right.IsConstant()) {
+        const auto& query_reader = left.IsConstant() ? left : right;
+        const auto& rows_reader = left.IsConstant() ? right : left;
+        const float* query;
+        duckdb::idx_t query_size;
+        if (!query_reader.Get(0, query, query_size)) {
+            result.SetVectorType(duckdb::VectorType::CONSTANT_VECTOR);
+            duckdb::ConstantVector::SetNull(result, true);
+            return;
+        }
+        const auto query_state = OP::Prepare(query, query_size);
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            const float* data;
+            duckdb::idx_t size;
+            if (!rows_reader.Get(row, data, size)) {
+                duckdb::FlatVector::SetNull(result, row, true);
+                continue;
+            }
+            CheckDimensions(function_name, query_size, size);
+            result_data[row] = OP::Operation(query_state, query, data, size);
+        }
+        return;
+    }
+
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const float *left_data, *right_data;
+        duckdb::idx_t left_size, right_size;
+        if (!left.Get(row, left_data, left_size) || !right.Get(row, right_data, right_size)) {
+            duckdb::FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        CheckDimensions(function_name, left_size, right_size);
+        result_data[row] = OP::Operation(OP::Prepare(left_data, left_size), left_data, right_data, left_size);
+    }
+}
+
+void VectorSimilarity::ExecuteCosineSimilarity(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                               duckdb::Vector& result) {
+    ExecuteMetric<CosineSimilarityOperator>(args, state, result);
+}
+
+void VectorSimilarity::ExecuteInnerProduct(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                           duckdb::Vector& result) {
+    ExecuteMetric<InnerProductOperator>(args, state, result);
+}
+
+void VectorSimilarity::ExecuteL2Distance(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                         duckdb::Vector& result) {
+    ExecuteMetric<L2DistanceOperator>(args, state, result);
+}
+
+void VectorSimilarity::ExecuteL1Distance(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                         duckdb::Vector& result) {
+    ExecuteMetric<L1DistanceOperator>(args, state, result);
+}
+
+void VectorSimilarity::ExecuteNormalize(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                        duckdb::Vector& result) {
+    WriteNormalized(args, state, result, 0);
+}
+
+void VectorSimilarity::ExecuteTruncate(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                       duckdb::Vector& result) {
+    // The size is a constant, checked while binding
+    WriteNormalized(args, state, result, static_cast<duckdb::idx_t>(args.data[1].GetValue(0).GetValue<int32_t>()));
+}
+
+void VectorSimilarity::WriteNormalized(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                       duckdb::Vector& result, const duckdb::idx_t truncated_size) {
+    const auto& function_name = state.expr.Cast<duckdb::BoundFunctionExpression>().function.name;
+    const FloatVectorReader input(args.data[0], args.size());
+    const auto count = input.IsConstant() ? 1 : args.size();
+    result.SetVectorType(input.IsConstant() ? duckdb::VectorType::CONSTANT_VECTOR : duckdb::VectorType::FLAT_VECTOR);
+    const auto is_array = result.GetType().id() == duckdb::LogicalTypeId::ARRAY;
+
+    duckdb::list_entry_t* list_entries = nullptr;
+    if (!is_array) {
+        duckdb::idx_t total_size = 0;
+        for (duckdb::idx_t row = 0; row < count; row++) {
+            const float* data;
+            duckdb::idx_t size;
+            if (input.Get(row, data, size)) {
+                total_size += truncated_size > 0 ? std::min(size, truncated_size) : size;
+            }
+        }
+        duckdb::ListVector::Reserve(result, total_size);
+        list_entries = duckdb::ConstantVector::GetData<duckdb::list_entry_t>(result);
+    }
+    auto& child = is_array ? duckdb::ArrayVector::GetEntry(result) : duckdb::ListVector::GetEntry(result);
+    auto child_data = duckdb::FlatVector::GetData<float>(child);
+
+    duckdb::idx_t offset = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+        const float* data;
+        duckdb::idx_t size;
+        if (!input.Get(row, data, size)) {
+            if (input.IsConstant()) {
+                duckdb::ConstantVector::SetNull(result, true);
+            } else {
+                duckdb::FlatVector::SetNull(result, row, true);
+            }
+            continue;
+        }
+        if (truncated_size > 0) {
+            if (size < truncated_size) {
+                throw std::runtime_error(duckdb_fmt::format("{}: Cannot truncate a vector of {} dimensions to {}.",
+                                                            function_name, size, truncated_size));
+            }
+            size = truncated_size;
+        }
+
+        if (is_array) {
+            offset = row * size;
+        } else {
+            list_entries[row] = duckdb::list_entry_t(offset, size);
+        }
+        const auto norm = std::sqrt(VectorKernels::SquaredNorm(data, size));
+        // The leading dimensions of a truncated vector are scaled back to unit length. A zero vector has no
+        // direction, it is returned unchanged.
+        const auto scale = norm > 0 ? 1.0f / norm : 1.0f;
+        for (duckdb::idx_t i = 0; i < size; i++) {
+            child_data[offset + i] = data[i] * scale;
+        }
+        if (!is_array) {
+            offset += size;
+        }
+    }
+    if (!is_array) {
+        duckdb::ListVector::SetListSize(result, offset);
+    }
+}
+
+} // namespace flockmtl
@@ -0,0 +1,30 @@
+#include "flockmtl/functions/scalar/vector_similarity.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void ScalarRegistry::RegisterVectorSimilarity(duckdb::DatabaseInstance& db) {
+    const duckdb::vector<duckdb::LogicalType> metric_arguments = {duckdb::LogicalType::ANY, duckdb::LogicalType::ANY};
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_cosine_similarity", metric_arguments, duckdb::LogicalType::DOUBLE,
+                                   VectorSimilarity::ExecuteCosineSimilarity, VectorSimilarity::Bind));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_inner_product", metric_arguments, duckdb::LogicalType::DOUBLE,
+                                   VectorSimilarity::ExecuteInnerProduct, VectorSimilarity::Bind));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_l2_distance", metric_arguments, duckdb::LogicalType::DOUBLE,
+                                   VectorSimilarity::ExecuteL2Distance, VectorSimilarity::Bind));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_l1_distance", metric_arguments, duckdb::LogicalType::DOUBLE,
+                                   VectorSimilarity::ExecuteL1Distance, VectorSimilarity::Bind));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_normalize", {duckdb::LogicalType::ANY},
+                                   duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT),
+                                   VectorSimilarity::ExecuteNormalize, VectorSimilarity::BindNormalize));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::ScalarFunction("vector_truncate", {duckdb::LogicalType::ANY, duckdb::LogicalType::INTEGER},
+                                   duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT),
+                                   VectorSimilarity::ExecuteTruncate, VectorSimilarity::BindTruncate));
+}
+
+} // namespace flockmtl
@@ -0,0 +1,136 @@
+#include "flockmtl/functions/table/chunk_text.hpp"
+
+#include <string_view>
+
+#include "flockmtl/model_manager/tiktoken.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct ChunkTextBindData : public duckdb::TableFunctionData {
+    size_t max_tokens;
+    size_t overlap;
+};
+
+struct ChunkTextState : public duckdb::LocalTableFunctionState {
+    // Row of the input chunk being split, with the offset and index of its next chunk
+    duckdb::idx_t row = 0;
+    size_t offset = 0;
+    int32_t chunk_index = 0;
+    // Start offsets of the tokens of the current chunk, reused from one chunk to the next
+    std::vector<size_t> token_starts;
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> ChunkText::Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<duckdb::string>& names) {
+    if (input.input_table_types.size() != 2 || input.input_table_types[1].id() != duckdb::LogicalTypeId::VARCHAR) {
+        throw std::runtime_error("chunk_text expects a table of two columns: a document id and a VARCHAR text.");
+    }
+
+    auto bind_data = duckdb::make_uniq<ChunkTextBindData>();
+    bind_data->max_tokens = GetCountArgument(input.named_parameters, "max_tokens", default_max_tokens);
+    bind_data->overlap = bind_data->max_tokens / default_overlap_divisor;
+    if (const auto overlap = input.named_parameters.find("overlap");
+        overlap != input.named_parameters.end() && !overlap->second.IsNull()) {
+        const auto value = overlap->second.GetValue<int64_t>();
+        if (value < 0 || static_cast<size_t>(value) >= bind_data->max_tokens) {
+            throw std::runtime_error("The `overlap` argument must be between 0 and `max_tokens` - 1.");
+        }
+        bind_data->overlap = value;
+    }
+
+    return_types = {input.input_table_types[0], duckdb::LogicalType::INTEGER, duckdb::LogicalType::BIGINT,
+                    duckdb::LogicalType::BIGINT, duckdb::LogicalType::VARCHAR};
+    names = {input.input_table_names[0], "chunk_index", "start_offset", "end_offset", "chunk"};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState> ChunkText::InitLocal(duckdb::ExecutionContext& context,
+                                                                         duckdb::TableFunctionInitInput& input,
+                                                                         duckdb::GlobalTableFunctionState* state) {
+    const auto& bind_data = input.bind_data->Cast<ChunkTextBindData>();
+    auto local_state = duckdb::make_uniq<ChunkTextState>();
+    local_state->token_starts.reserve(bind_data.max_tokens);
+    return std::move(local_state);
+}
+
+duckdb::OperatorResultType ChunkText::Execute(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                              duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<ChunkTextBindData>();
+    auto& state = data.local_state->Cast<ChunkTextState>();
+
+    duckdb::UnifiedVectorFormat text_format;
+    input.data[1].ToUnifiedFormat(input.size(), text_format);
+    const auto texts = duckdb::UnifiedVectorFormat::GetData<duckdb::string_t>(text_format);
+    auto chunk_indexes = duckdb::FlatVector::GetData<int32_t>(output.data[1]);
+    auto start_offsets = duckdb::FlatVector::GetData<int64_t>(output.data[2]);
+    auto end_offsets = duckdb::FlatVector::GetData<int64_t>(output.data[3]);
+    auto chunks = duckdb::FlatVector::GetData<duckdb::string_t>(output.data[4]);
+    // Input row of every output row, for copying the document ids
+    duckdb::SelectionVector documents(STANDARD_VECTOR_SIZE);
+
+    auto next_row = [&]() {
+        state.row++;
+        state.offset = 0;
+        state.chunk_index = 0;
+    };
+
+    duckdb::idx_t count = 0;
+    while (state.row < input.size() && count < STANDARD_VECTOR_SIZE) {
+        const auto index = text_format.sel->get_index(state.row);
+        if (!text_format.validity.RowIsValid(index)) {
+            next_row();
+            continue;
+        }
+        const std::string_view text(texts[index].GetData(), texts[index].GetSize());
+
+        // Reads the tokens of the next chunk from where the previous one left off, never the whole document
+        state.token_starts.clear();
+        size_t begin;
+        size_t end = state.offset;
+        size_t chunk_end = 0;
+        while (state.token_starts.size() < bind_data.max_tokens && Tiktoken::NextToken(text, end, begin, end)) {
+            state.token_starts.push_back(begin);
+            chunk_end = end;
+        }
+        if (state.token_starts.empty()) {
+            next_row();
+            continue;
+        }
+
+        const auto chunk_begin = state.token_starts.front();
+        documents.set_index(count, state.row);
+        chunk_indexes[count] = state.chunk_index;
+        start_offsets[count] = static_cast<int64_t>(chunk_begin);
+        end_offsets[count] = static_cast<int64_t>(chunk_end);
+        chunks[count] = duckdb::StringVector::AddString(output.data[4], text.data() + chunk_begin,
+                                                        chunk_end - chunk_begin);
+        count++;
+
+        // The next chunk repeats the last `overlap` tokens of this one, unless this one reached the end of the text
+        size_t next_begin;
+        size_t next_end;
+        if (state.token_starts.size() < bind_data.max_tokens || !Tiktoken::NextToken(text, end, next_begin, next_end)) {
+            next_row();
+        } else {
+            state.offset = bind_data.overlap > 0 ? state.token_starts[bind_data.max_tokens - bind_data.overlap]
+                                                 : next_begin;
+            state.chunk_index++;
+        }
+    }
+
+    duckdb::VectorOperations::Copy(input.data[0], output.data[0], documents, count, 0, 0);
+    output.SetCardinality(count);
+    if (state.row < input.size()) {
+        return duckdb::OperatorResultType::HAVE_MORE_OUTPUT;
+    }
+    state.row = 0;
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,15 @@
+#include "flockmtl/functions/table/chunk_text.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterChunkText(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("chunk_text", {duckdb::LogicalType::TABLE}, nullptr, ChunkText::Bind, nullptr,
+                                   ChunkText::InitLocal);
+    function.in_out_function = ChunkText::Execute;
+    function.named_parameters["max_tokens"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["overlap"] = duckdb::LogicalType::INTEGER;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
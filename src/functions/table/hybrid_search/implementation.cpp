@@ -0,0 +1,133 @@
+#include "flockmtl/functions/table/hybrid_search.hpp"
+
+#include "duckdb/parser/keyword_helper.hpp"
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct HybridSearchBindData : public duckdb::TableFunctionData {
+    EmbeddingSource source;
+    std::string text_column;
+    std::string query_text;
+    std::vector<float> query_embedding;
+    HybridSearchOptions options;
+    // Columns of the table, returned before the fusion columns
+    duckdb::vector<duckdb::string> table_columns;
+};
+
+struct HybridSearchState : public duckdb::GlobalTableFunctionState {
+    duckdb::unique_ptr<duckdb::QueryResult> rows;
+};
+
+// Columns appended to the ones of the table
+const duckdb::vector<duckdb::string> fusion_columns = {"hybrid_score", "lexical_rank", "vector_rank"};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> HybridSearchFunction::Bind(duckdb::ClientContext& context,
+                                                                    duckdb::TableFunctionBindInput& input,
+                                                                    duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                    duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<HybridSearchBindData>();
+    bind_data->source.table_name = GetStringArgument(input.inputs[0], "table_name");
+    bind_data->source.key_column = GetStringArgument(input.inputs[1], "key_column");
+    bind_data->text_column = GetStringArgument(input.inputs[2], "text_column");
+    bind_data->source.embedding_column = GetStringArgument(input.inputs[3], "embedding_column");
+    bind_data->query_text = GetStringArgument(input.inputs[4], "query_text");
+    bind_data->query_embedding = GetVectorArgument(input.inputs[5], "query_embedding");
+    bind_data->options.k = GetCountArgument(input.inputs[6], "k");
+    bind_data->options.candidates = GetCountArgument(input.named_parameters, "candidates", default_candidates);
+    bind_data->options.metric = GetMetricArgument(input.named_parameters, VectorMetric::COSINE);
+    if (const auto fusion = input.named_parameters.find("fusion");
+        fusion != input.named_parameters.end() && !fusion->second.IsNull()) {
+        bind_data->options.fusion = HybridSearch::FusionFromString(fusion->second.ToString());
+    }
+
+    // The rows are returned with every column of the table, only the projected ones are fetched
+    auto con = Config::GetConnection();
+    auto table = con.Query(duckdb_fmt::format("SELECT * FROM {} LIMIT 0;", bind_data->source.GetQuotedTable()));
+    if (table->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to read the columns of table '{}': {}",
+                                                    bind_data->source.table_name, table->GetError()));
+    }
+    for (duckdb::idx_t i = 0; i < table->names.size(); i++) {
+        names.push_back(table->names[i]);
+        return_types.push_back(table->types[i]);
+    }
+    bind_data->table_columns = table->names;
+    names.insert(names.end(), fusion_columns.begin(), fusion_columns.end());
+    return_types.insert(return_types.end(), {duckdb::LogicalType::DOUBLE, duckdb::LogicalType::INTEGER,
+                                             duckdb::LogicalType::INTEGER});
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> HybridSearchFunction::Init(duckdb::ClientContext& context,
+                                                                                duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<HybridSearchBindData>();
+    HybridSearch search(bind_data.options, bind_data.query_text, bind_data.query_embedding);
+    const auto matches = search.Run(bind_data.source, bind_data.text_column, GetNumberOfThreads(context));
+
+    auto state = duckdb::make_uniq<HybridSearchState>();
+    if (matches.empty()) {
+        return std::move(state);
+    }
+
+    // Late materialization: only the final rows are joined back to the table, for the projected columns only
+    std::string projection;
+    for (const auto column_id : input.column_ids) {
+        std::string column;
+        if (column_id == duckdb::COLUMN_IDENTIFIER_ROW_ID) {
+            column = "h.position::BIGINT";
+        } else if (column_id < bind_data.table_columns.size()) {
+            column = "t." + duckdb::KeywordHelper::WriteOptionallyQuoted(bind_data.table_columns[column_id]);
+        } else {
+            column = "h." + fusion_columns[column_id - bind_data.table_columns.size()];
+        }
+        projection += (projection.empty() ? "" : ", ") + column;
+    }
+    std::string matches_values;
+    for (size_t i = 0; i < matches.size(); i++) {
+        const auto& match = matches[i];
+        const auto rank = [](const int32_t value) { return value > 0 ? std::to_string(value) : "NULL"; };
+        matches_values += duckdb_fmt::format("{}({}, {}, {}::DOUBLE, {}::INTEGER, {}::INTEGER)", i == 0 ? "" : ", ",
+                                             match.key, i, match.score, rank(match.lexical_rank),
+                                             rank(match.vector_rank));
+    }
+
+    auto con = Config::GetConnection();
+    state->rows = con.Query(duckdb_fmt::format(" SELECT {} "
+                                               "   FROM {} AS t "
+                                               "   JOIN (VALUES {}) AS h(row_key, position, hybrid_score, "
+                                               "                         lexical_rank, vector_rank) "
+                                               "     ON t.{} = h.row_key "
+                                               "  ORDER BY h.position; ",
+                                               projection, bind_data.source.GetQuotedTable(), matches_values,
+                                               bind_data.source.GetQuotedKey()));
+    if (state->rows->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to fetch the rows of table '{}': {}",
+                                                    bind_data.source.table_name, state->rows->GetError()));
+    }
+    return std::move(state);
+}
+
+void HybridSearchFunction::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                   duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<HybridSearchState>();
+    if (!state.rows) {
+        output.SetCardinality(0);
+        return;
+    }
+    auto chunk = state.rows->Fetch();
+    if (!chunk) {
+        output.SetCardinality(0);
+        return;
+    }
+    for (duckdb::idx_t column = 0; column < output.ColumnCount(); column++) {
+        output.data[column].Reference(chunk->data[column]);
+    }
+    output.SetCardinality(chunk->size());
+}
+
+} // namespace flockmtl
@@ -0,0 +1,22 @@
+#include "flockmtl/functions/table/hybrid_search.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterHybridSearch(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("hybrid_search",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::ANY,
+                                    duckdb::LogicalType::INTEGER},
+                                   HybridSearchFunction::Execute, HybridSearchFunction::Bind,
+                                   HybridSearchFunction::Init);
+    function.named_parameters["fusion"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["candidates"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    // Only the projected columns of the table are fetched for the returned rows
+    function.projection_pushdown = true;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,289 @@
+#include "flockmtl/functions/table/llm_map.hpp"
+
+#include <chrono>
+#include <deque>
+#include <future>
+
+#include "flockmtl/functions/batch_response_builder.hpp"
+#include "flockmtl/functions/scalar/scalar.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct LlmMapBindData : public duckdb::TableFunctionData {
+    nlohmann::json model_json;
+    ModelDetails model_details;
+    std::string prompt;
+    ScalarFunctionType function_type;
+    size_t max_in_flight;
+    size_t max_outstanding_chunks;
+    // Tokens of the context window left for the rows of a batch, once the prompt and the table header are counted
+    int available_tokens;
+    duckdb::vector<duckdb::string> column_names;
+};
+
+// A batch sent to the model, with the model it was sent with; the model is reused once the batch completes
+struct InFlightBatch {
+    std::unique_ptr<Model> model;
+    std::future<std::vector<nlohmann::json>> responses;
+};
+
+struct LlmMapState : public duckdb::LocalTableFunctionState {
+    std::shared_ptr<BatchSizeController> controller;
+    // Copies of the input chunks holding rows not emitted yet, and the next row to emit of the first one
+    std::deque<duckdb::unique_ptr<duckdb::DataChunk>> chunks;
+    duckdb::idx_t emit_row = 0;
+    // Rows buffered for the next batch, with their tokens
+    std::vector<nlohmann::json> pending;
+    int pending_tokens = 0;
+    // Batches sent to the model, in input order
+    std::deque<InFlightBatch> in_flight;
+    // Responses of the completed rows not emitted yet, in input order
+    std::deque<nlohmann::json> responses;
+    // Whether the current input chunk was buffered already; it is passed again while its output is emitted
+    bool input_buffered = false;
+    // Models of the completed batches. Every batch in flight has its own, so that every provider records the usage
+    // of its own calls.
+    std::vector<std::unique_ptr<Model>> idle_models;
+};
+
+nlohmann::json GetStructArgument(const duckdb::named_parameter_map_t& named_parameters, const std::string& argument) {
+    const auto parameter = named_parameters.find(argument);
+    if (parameter == named_parameters.end() || parameter->second.IsNull() ||
+        parameter->second.type().id() != duckdb::LogicalTypeId::STRUCT) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument must be a struct.", argument));
+    }
+    const duckdb::Vector vector(parameter->second);
+    return CastVectorOfStructsToJson(vector, 1)[0];
+}
+
+ScalarFunctionType GetFunctionType(const duckdb::named_parameter_map_t& named_parameters) {
+    const auto parameter = named_parameters.find("function");
+    if (parameter == named_parameters.end() || parameter->second.IsNull()) {
+        return ScalarFunctionType::COMPLETE;
+    }
+    const auto function = parameter->second.ToString();
+    if (function == "complete") {
+        return ScalarFunctionType::COMPLETE;
+    }
+    if (function == "complete_json") {
+        return ScalarFunctionType::COMPLETE_JSON;
+    }
+    if (function == "filter") {
+        return ScalarFunctionType::FILTER;
+    }
+    throw std::runtime_error(duckdb_fmt::format(
+        "Unsupported function `{}`, expected `complete`, `complete_json` or `filter`.", function));
+}
+
+std::vector<nlohmann::json> CompleteBatch(const LlmMapBindData& bind_data, Model& model,
+                                          const std::vector<nlohmann::json>& batch) {
+    const auto responses =
+        ScalarFunctionBase::BatchAndComplete(batch, bind_data.prompt, bind_data.function_type, model);
+    if (responses.size() != batch.size()) {
+        throw std::runtime_error(duckdb_fmt::format("The model returned {} responses for {} tuples.",
+                                                    responses.size(), batch.size()));
+    }
+    return responses.get<std::vector<nlohmann::json>>();
+}
+
+// Waits for the first batch in flight and queues its responses
+void CollectBatch(LlmMapState& state) {
+    auto& batch = state.in_flight.front();
+    for (auto& response : batch.responses.get()) {
+        state.responses.push_back(std::move(response));
+    }
+    state.idle_models.push_back(std::move(batch.model));
+    state.in_flight.pop_front();
+}
+
+// Queues the responses of the batches completed so far, in input order, without waiting for the others
+void CollectCompletedBatches(LlmMapState& state) {
+    while (!state.in_flight.empty() &&
+           state.in_flight.front().responses.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        CollectBatch(state);
+    }
+}
+
+// Sends the pending rows to the model in the background, once fewer than `max_in_flight` batches are in flight
+void CloseBatch(const LlmMapBindData& bind_data, LlmMapState& state) {
+    while (state.in_flight.size() >= bind_data.max_in_flight) {
+        CollectBatch(state);
+    }
+
+    InFlightBatch batch;
+    if (state.idle_models.empty()) {
+        batch.model = std::make_unique<Model>(bind_data.model_json);
+    } else {
+        batch.model = std::move(state.idle_models.back());
+        state.idle_models.pop_back();
+    }
+    batch.responses = std::async(std::launch::async, CompleteBatch, std::cref(bind_data), std::ref(*batch.model),
+                                 std::move(state.pending));
+    state.in_flight.push_back(std::move(batch));
+    state.pending.clear();
+    state.pending_tokens = 0;
+}
+
+// Buffers a row, closing the pending batch first when the row does not fit in it
+void AddTuple(const LlmMapBindData& bind_data, LlmMapState& state, nlohmann::json tuple) {
+    const auto num_tokens = Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownSingleTuple(tuple));
+    if (num_tokens > bind_data.available_tokens) {
+        throw std::runtime_error("A single tuple exceeds the model's available context window");
+    }
+
+    // Offline, every row goes into a single batch job, which splits them itself
+    if (!bind_data.model_details.offline_execution && !state.pending.empty()) {
+        const auto batch_size = state.controller->GetBatchSize();
+        if (state.pending_tokens + num_tokens > bind_data.available_tokens ||
+            (batch_size > 0 && state.pending.size() >= batch_size)) {
+            CloseBatch(bind_data, state);
+        }
+    }
+    state.pending.push_back(std::move(tuple));
+    state.pending_tokens += num_tokens;
+}
+
+void BufferInput(duckdb::ExecutionContext& context, const LlmMapBindData& bind_data, LlmMapState& state,
+                 duckdb::DataChunk& input) {
+    if (input.size() == 0) {
+        return;
+    }
+    auto chunk = duckdb::make_uniq<duckdb::DataChunk>();
+    chunk->Initialize(duckdb::Allocator::Get(context.client), input.GetTypes(), input.size());
+    input.Copy(*chunk);
+
+    for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+        nlohmann::json tuple;
+        for (duckdb::idx_t column = 0; column < chunk->ColumnCount(); column++) {
+            tuple[bind_data.column_names[column]] = chunk->GetValue(column, row).ToString();
+        }
+        AddTuple(bind_data, state, std::move(tuple));
+    }
+    state.chunks.push_back(std::move(chunk));
+}
+
+// Emits the rows whose response is ready, the input columns followed by the response
+void EmitRows(LlmMapState& state, duckdb::DataChunk& output) {
+    const auto count = std::min<duckdb::idx_t>(state.responses.size(), STANDARD_VECTOR_SIZE);
+    auto& response_vector = output.data[output.ColumnCount() - 1];
+    const auto responses = duckdb::FlatVector::GetData<duckdb::string_t>(response_vector);
+
+    duckdb::idx_t emitted = 0;
+    while (emitted < count) {
+        const auto& chunk = *state.chunks.front();
+        const auto rows = std::min(count - emitted, chunk.size() - state.emit_row);
+        for (duckdb::idx_t column = 0; column < chunk.ColumnCount(); column++) {
+            duckdb::VectorOperations::Copy(chunk.data[column], output.data[column], state.emit_row + rows,
+                                           state.emit_row, emitted);
+        }
+        state.emit_row += rows;
+        emitted += rows;
+        if (state.emit_row == chunk.size()) {
+            state.chunks.pop_front();
+            state.emit_row = 0;
+        }
+    }
+    for (duckdb::idx_t i = 0; i < count; i++) {
+        responses[i] = duckdb::StringVector::AddString(response_vector, state.responses.front().dump());
+        state.responses.pop_front();
+    }
+    output.SetCardinality(count);
+}
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> LlmMap::Bind(duckdb::ClientContext& context,
+                                                      duckdb::TableFunctionBindInput& input,
+                                                      duckdb::vector<duckdb::LogicalType>& return_types,
+                                                      duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<LlmMapBindData>();
+    bind_data->model_json = GetStructArgument(input.named_parameters, "model");
+    bind_data->prompt =
+        PromptManager::CreatePromptDetails(GetStructArgument(input.named_parameters, "prompt")).prompt;
+    bind_data->function_type = GetFunctionType(input.named_parameters);
+    bind_data->max_in_flight = GetCountArgument(input.named_parameters, "max_in_flight", default_max_in_flight);
+    bind_data->max_outstanding_chunks =
+        GetCountArgument(input.named_parameters, "max_outstanding_chunks", default_max_outstanding_chunks);
+    bind_data->column_names = input.input_table_names;
+
+    // The model is resolved once here, which also reports a wrong model before the query runs
+    Model model(bind_data->model_json);
+    bind_data->model_details = model.GetModelDetails();
+    nlohmann::json header;
+    for (const auto& name : input.input_table_names) {
+        header[name] = "";
+    }
+    bind_data->available_tokens =
+        ScalarFunctionBase::GetAvailableTokens(bind_data->prompt, bind_data->function_type, model) -
+        static_cast<int>(Tiktoken::GetNumTokens(PromptManager::ConstructMarkdownHeader(header)));
+
+    return_types = input.input_table_types;
+    return_types.push_back(duckdb::LogicalType::VARCHAR);
+    names = input.input_table_names;
+    names.push_back("response");
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::LocalTableFunctionState> LlmMap::InitLocal(duckdb::ExecutionContext& context,
+                                                                      duckdb::TableFunctionInitInput& input,
+                                                                      duckdb::GlobalTableFunctionState* state) {
+    const auto& bind_data = input.bind_data->Cast<LlmMapBindData>();
+    auto local_state = duckdb::make_uniq<LlmMapState>();
+    local_state->controller = BatchSizeController::Get(bind_data.model_details, bind_data.function_type);
+    return std::move(local_state);
+}
+
+duckdb::OperatorResultType LlmMap::Execute(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                           duckdb::DataChunk& input, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<LlmMapBindData>();
+    auto& state = data.local_state->Cast<LlmMapState>();
+    RequestScheduler::OriginScope origin(context.client);
+
+    if (!state.input_buffered) {
+        BufferInput(context, bind_data, state, input);
+        state.input_buffered = true;
+    }
+
+    // The batches complete in the background while the upstream operators produce the next chunks. The pipeline only
+    // blocks on the oldest batch once too many chunks wait for their responses.
+    CollectCompletedBatches(state);
+    while (!bind_data.model_details.offline_execution && state.responses.empty() &&
+           state.chunks.size() > bind_data.max_outstanding_chunks) {
+        if (state.in_flight.empty()) {
+            // The oldest rows are all still pending, they are sent without waiting for their batch to fill
+            CloseBatch(bind_data, state);
+        }
+        CollectBatch(state);
+    }
+
+    EmitRows(state, output);
+    if (!state.responses.empty()) {
+        return duckdb::OperatorResultType::HAVE_MORE_OUTPUT;
+    }
+    state.input_buffered = false;
+    return duckdb::OperatorResultType::NEED_MORE_INPUT;
+}
+
+duckdb::OperatorFinalizeResultType LlmMap::Finalize(duckdb::ExecutionContext& context,
+                                                    duckdb::TableFunctionInput& data, duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<LlmMapBindData>();
+    auto& state = data.local_state->Cast<LlmMapState>();
+    RequestScheduler::OriginScope origin(context.client);
+
+    if (!state.pending.empty()) {
+        CloseBatch(bind_data, state);
+    }
+    if (state.responses.empty() && !state.in_flight.empty()) {
+        CollectBatch(state);
+    }
+
+    EmitRows(state, output);
+    if (state.responses.empty() && state.in_flight.empty()) {
+        return duckdb::OperatorFinalizeResultType::FINISHED;
+    }
+    return duckdb::OperatorFinalizeResultType::HAVE_MORE_OUTPUT;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,19 @@
+#include "flockmtl/functions/table/llm_map.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterLlmMap(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("llm_map", {duckdb::LogicalType::TABLE}, nullptr, LlmMap::Bind, nullptr,
+                                   LlmMap::InitLocal);
+    function.in_out_function = LlmMap::Execute;
+    function.in_out_function_final = LlmMap::Finalize;
+    function.named_parameters["model"] = duckdb::LogicalType::ANY;
+    function.named_parameters["prompt"] = duckdb::LogicalType::ANY;
+    function.named_parameters["function"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["max_in_flight"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["max_outstanding_chunks"] = duckdb::LogicalType::INTEGER;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,104 @@
+#include "flockmtl/functions/table/table.hpp"
+
+#include "duckdb/parallel/task_scheduler.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+bool IsNestedType(const duckdb::LogicalType& type) {
+    return type.id() == duckdb::LogicalTypeId::LIST || type.id() == duckdb::LogicalTypeId::ARRAY;
+}
+
+const duckdb::vector<duckdb::Value>& GetChildren(const duckdb::Value& value) {
+    return value.type().id() == duckdb::LogicalTypeId::ARRAY ? duckdb::ArrayValue::GetChildren(value)
+                                                             : duckdb::ListValue::GetChildren(value);
+}
+
+const duckdb::LogicalType& GetChildType(const duckdb::LogicalType& type) {
+    return type.id() == duckdb::LogicalTypeId::ARRAY ? duckdb::ArrayType::GetChildType(type)
+                                                     : duckdb::ListType::GetChildType(type);
+}
+
+} // namespace
+
+std::string TableFunctionBase::GetStringArgument(const duckdb::Value& value, const std::string& argument) {
+    if (value.IsNull()) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument cannot be NULL.", argument));
+    }
+    return value.ToString();
+}
+
+size_t TableFunctionBase::GetCountArgument(const duckdb::Value& value, const std::string& argument) {
+    if (value.IsNull() || value.GetValue<int64_t>() <= 0) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument must be a positive number.", argument));
+    }
+    return value.GetValue<int64_t>();
+}
+
+size_t TableFunctionBase::GetCountArgument(const duckdb::named_parameter_map_t& named_parameters,
+                                           const std::string& argument, const size_t default_value) {
+    const auto parameter = named_parameters.find(argument);
+    if (parameter == named_parameters.end() || parameter->second.IsNull()) {
+        return default_value;
+    }
+    return GetCountArgument(parameter->second, argument);
+}
+
+VectorMetric TableFunctionBase::GetMetricArgument(const duckdb::named_parameter_map_t& named_parameters,
+                                                  const VectorMetric default_value) {
+    const auto parameter = named_parameters.find("metric");
+    if (parameter == named_parameters.end() || parameter->second.IsNull()) {
+        return default_value;
+    }
+    return VectorMetricUtil::FromString(parameter->second.ToString());
+}
+
+std::vector<float> TableFunctionBase::GetVectorArgument(const duckdb::Value& value, const std::string& argument) {
+    if (value.IsNull()) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument cannot be NULL.", argument));
+    }
+    if (!IsNestedType(value.type()) || !GetChildType(value.type()).IsNumeric()) {
+        throw std::runtime_error(
+            duckdb_fmt::format("The `{}` argument must be a FLOAT[N] array or a numeric list.", argument));
+    }
+
+    std::vector<float> vector;
+    vector.reserve(GetChildren(value).size());
+    for (const auto& element : GetChildren(value)) {
+        if (element.IsNull()) {
+            throw std::runtime_error(duckdb_fmt::format("The `{}` argument cannot contain NULL elements.", argument));
+        }
+        vector.push_back(element.GetValue<float>());
+    }
+    if (vector.empty()) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument cannot be empty.", argument));
+    }
+    return vector;
+}
+
+std::vector<std::vector<float>> TableFunctionBase::GetVectorsArgument(const duckdb::Value& value,
+                                                                      const std::string& argument) {
+    if (value.IsNull() || !IsNestedType(value.type()) || !IsNestedType(GetChildType(value.type()))) {
+        return {GetVectorArgument(value, argument)};
+    }
+
+    std::vector<std::vector<float>> vectors;
+    for (const auto& child : GetChildren(value)) {
+        vectors.push_back(GetVectorArgument(child, argument));
+        if (vectors.back().size() != vectors.front().size()) {
+            throw std::runtime_error(
+                duckdb_fmt::format("Every vector of the `{}` argument must have the same dimensions.", argument));
+        }
+    }
+    if (vectors.empty()) {
+        throw std::runtime_error(duckdb_fmt::format("The `{}` argument cannot be empty.", argument));
+    }
+    return vectors;
+}
+
+size_t TableFunctionBase::GetNumberOfThreads(duckdb::ClientContext& context) {
+    return duckdb::TaskScheduler::GetScheduler(context).NumberOfThreads();
+}
+
+} // namespace flockmtl
@@ -0,0 +1,156 @@
+#include "flockmtl/functions/table/vector_index.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct VectorIndexBindData : public duckdb::TableFunctionData {
+    VectorIndexDefinition definition;
+};
+
+struct VectorIndexSearchBindData : public duckdb::TableFunctionData {
+    std::string index_name;
+    std::vector<float> query;
+    size_t k;
+    size_t ef_search;
+};
+
+// Index maintenance runs once per query and returns a single summary row
+struct VectorIndexOperationState : public duckdb::GlobalTableFunctionState {
+    bool finished = false;
+};
+
+struct VectorIndexSearchState : public duckdb::GlobalTableFunctionState {
+    std::vector<std::pair<int64_t, float>> results;
+    size_t offset = 0;
+};
+
+duckdb::unique_ptr<duckdb::FunctionData> BindIndexName(duckdb::TableFunctionBindInput& input,
+                                                        duckdb::vector<duckdb::LogicalType>& return_types,
+                                                        duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorIndexBindData>();
+    bind_data->definition.index_name = TableFunctionBase::GetStringArgument(input.inputs[0], "index_name");
+    return_types = {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::BIGINT};
+    names = {"index_name", "indexed_rows"};
+    return std::move(bind_data);
+}
+
+void EmitSummary(duckdb::TableFunctionInput& data, duckdb::DataChunk& output, const std::function<size_t()>& run) {
+    auto& state = data.global_state->Cast<VectorIndexOperationState>();
+    if (state.finished) {
+        return;
+    }
+    const auto indexed_rows = run();
+    output.SetValue(0, 0, duckdb::Value(data.bind_data->Cast<VectorIndexBindData>().definition.index_name));
+    output.SetValue(1, 0, duckdb::Value::BIGINT(static_cast<int64_t>(indexed_rows)));
+    output.SetCardinality(1);
+    state.finished = true;
+}
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorIndexFunctions::BindCreate(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                                 duckdb::vector<duckdb::LogicalType>& return_types,
+                                 duckdb::vector<duckdb::string>& names) {
+    auto bind_data = BindIndexName(input, return_types, names);
+    auto& definition = bind_data->Cast<VectorIndexBindData>().definition;
+    definition.table_name = GetStringArgument(input.inputs[1], "table_name");
+    definition.key_column = GetStringArgument(input.inputs[2], "key_column");
+    definition.embedding_column = GetStringArgument(input.inputs[3], "embedding_column");
+    definition.metric = GetMetricArgument(input.named_parameters, definition.metric);
+    definition.m = GetCountArgument(input.named_parameters, "m", definition.m);
+    definition.ef_construction =
+        GetCountArgument(input.named_parameters, "ef_construction", definition.ef_construction);
+    return bind_data;
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorIndexFunctions::BindRefresh(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                                  duckdb::vector<duckdb::LogicalType>& return_types,
+                                  duckdb::vector<duckdb::string>& names) {
+    return BindIndexName(input, return_types, names);
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorIndexFunctions::BindDrop(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                               duckdb::vector<duckdb::LogicalType>& return_types,
+                               duckdb::vector<duckdb::string>& names) {
+    return BindIndexName(input, return_types, names);
+}
+
+duckdb::unique_ptr<duckdb::FunctionData>
+VectorIndexFunctions::BindSearch(duckdb::ClientContext& context, duckdb::TableFunctionBindInput& input,
+                                 duckdb::vector<duckdb::LogicalType>& return_types,
+                                 duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorIndexSearchBindData>();
+    bind_data->index_name = GetStringArgument(input.inputs[0], "index_name");
+    bind_data->query = GetVectorArgument(input.inputs[1], "query");
+    bind_data->k = GetCountArgument(input.inputs[2], "k");
+    bind_data->ef_search =
+        GetCountArgument(input.named_parameters, "ef_search", VectorIndexManager::default_ef_search);
+
+    return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::FLOAT};
+    names = {"row_key", "distance"};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState>
+VectorIndexFunctions::InitOperation(duckdb::ClientContext& context, duckdb::TableFunctionInitInput& input) {
+    return duckdb::make_uniq<VectorIndexOperationState>();
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState>
+VectorIndexFunctions::InitSearch(duckdb::ClientContext& context, duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<VectorIndexSearchBindData>();
+    const auto index = VectorIndexManager::Get(bind_data.index_name);
+    if (bind_data.query.size() != index->GetDimensions()) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' expects a query with {} dimensions, got {}.",
+                                                    bind_data.index_name, index->GetDimensions(),
+                                                    bind_data.query.size()));
+    }
+
+    auto state = duckdb::make_uniq<VectorIndexSearchState>();
+    state->results = index->Search(bind_data.query.data(), bind_data.k, bind_data.ef_search);
+    return std::move(state);
+}
+
+void VectorIndexFunctions::ExecuteCreate(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                         duckdb::DataChunk& output) {
+    EmitSummary(data, output, [&]() {
+        return VectorIndexManager::Create(data.bind_data->Cast<VectorIndexBindData>().definition,
+                                          GetNumberOfThreads(context));
+    });
+}
+
+void VectorIndexFunctions::ExecuteRefresh(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                          duckdb::DataChunk& output) {
+    EmitSummary(data, output, [&]() {
+        return VectorIndexManager::Refresh(data.bind_data->Cast<VectorIndexBindData>().definition.index_name,
+                                           GetNumberOfThreads(context));
+    });
+}
+
+void VectorIndexFunctions::ExecuteDrop(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                       duckdb::DataChunk& output) {
+    EmitSummary(data, output, [&]() {
+        VectorIndexManager::Drop(data.bind_data->Cast<VectorIndexBindData>().definition.index_name);
+        return static_cast<size_t>(0);
+    });
+}
+
+void VectorIndexFunctions::ExecuteSearch(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                         duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<VectorIndexSearchState>();
+    const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, state.results.size() - state.offset);
+    auto keys = duckdb::FlatVector::GetData<int64_t>(output.data[0]);
+    auto distances = duckdb::FlatVector::GetData<float>(output.data[1]);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = state.results[state.offset + i].first;
+        distances[i] = state.results[state.offset + i].second;
+    }
+    state.offset += count;
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
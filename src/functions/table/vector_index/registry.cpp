@@ -0,0 +1,35 @@
+#include "flockmtl/functions/table/vector_index.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterVectorIndex(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction create_function(
+        "vector_index_create",
+        {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+         duckdb::LogicalType::VARCHAR},
+        VectorIndexFunctions::ExecuteCreate, VectorIndexFunctions::BindCreate, VectorIndexFunctions::InitOperation);
+    create_function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    create_function.named_parameters["m"] = duckdb::LogicalType::INTEGER;
+    create_function.named_parameters["ef_construction"] = duckdb::LogicalType::INTEGER;
+    duckdb::ExtensionUtil::RegisterFunction(db, create_function);
+
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::TableFunction("vector_index_refresh", {duckdb::LogicalType::VARCHAR},
+                                  VectorIndexFunctions::ExecuteRefresh, VectorIndexFunctions::BindRefresh,
+                                  VectorIndexFunctions::InitOperation));
+    duckdb::ExtensionUtil::RegisterFunction(
+        db, duckdb::TableFunction("vector_index_drop", {duckdb::LogicalType::VARCHAR},
+                                  VectorIndexFunctions::ExecuteDrop, VectorIndexFunctions::BindDrop,
+                                  VectorIndexFunctions::InitOperation));
+
+    duckdb::TableFunction search_function(
+        "vector_index_search",
+        {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT),
+         duckdb::LogicalType::INTEGER},
+        VectorIndexFunctions::ExecuteSearch, VectorIndexFunctions::BindSearch, VectorIndexFunctions::InitSearch);
+    search_function.named_parameters["ef_search"] = duckdb::LogicalType::INTEGER;
+    duckdb::ExtensionUtil::RegisterFunction(db, search_function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,122 @@
+#include "flockmtl/functions/table/vector_kmeans.hpp"
+
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct VectorKMeansBindData : public duckdb::TableFunctionData {
+    EmbeddingSource source;
+    KMeansOptions options;
+    // Whether one row per centroid is returned instead of one row per input row
+    bool output_centroids;
+};
+
+struct VectorKMeansState : public duckdb::GlobalTableFunctionState {
+    std::vector<int64_t> keys;
+    KMeansResult result;
+    size_t offset = 0;
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> VectorKMeans::Bind(duckdb::ClientContext& context,
+                                                            duckdb::TableFunctionBindInput& input,
+                                                            duckdb::vector<duckdb::LogicalType>& return_types,
+                                                            duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorKMeansBindData>();
+    bind_data->source.table_name = GetStringArgument(input.inputs[0], "table_name");
+    bind_data->source.key_column = GetStringArgument(input.inputs[1], "key_column");
+    bind_data->source.embedding_column = GetStringArgument(input.inputs[2], "embedding_column");
+    bind_data->options.k = GetCountArgument(input.inputs[3], "k");
+    bind_data->options.metric = GetMetricArgument(input.named_parameters, VectorMetric::L2);
+    bind_data->options.batch_size = GetCountArgument(input.named_parameters, "batch_size", 0);
+    bind_data->options.max_iterations =
+        GetCountArgument(input.named_parameters, "max_iterations",
+                         bind_data->options.batch_size > 0 ? default_mini_batch_iterations : default_max_iterations);
+    bind_data->options.seed = default_seed;
+    if (const auto seed = input.named_parameters.find("seed");
+        seed != input.named_parameters.end() && !seed->second.IsNull()) {
+        bind_data->options.seed = static_cast<uint64_t>(seed->second.GetValue<int64_t>());
+    }
+    if (bind_data->options.metric == VectorMetric::INNER_PRODUCT) {
+        throw std::runtime_error("K-means only supports the 'l2' and 'cosine' metrics.");
+    }
+
+    bind_data->output_centroids = false;
+    if (const auto output = input.named_parameters.find("output");
+        output != input.named_parameters.end() && !output->second.IsNull()) {
+        const auto value = duckdb::StringUtil::Lower(output->second.ToString());
+        if (value != "assignments" && value != "centroids") {
+            throw std::runtime_error("The `output` argument must be either 'assignments' or 'centroids'.");
+        }
+        bind_data->output_centroids = value == "centroids";
+    }
+
+    if (bind_data->output_centroids) {
+        return_types = {duckdb::LogicalType::INTEGER, duckdb::LogicalType::BIGINT,
+                        duckdb::LogicalType::LIST(duckdb::LogicalType::FLOAT)};
+        names = {"cluster", "size", "centroid"};
+    } else {
+        return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::INTEGER, duckdb::LogicalType::FLOAT};
+        names = {"row_key", "cluster", "distance"};
+    }
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> VectorKMeans::Init(duckdb::ClientContext& context,
+                                                                        duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<VectorKMeansBindData>();
+    auto con = Config::GetConnection();
+    EmbeddingScanner scanner(con, bind_data.source);
+    auto data = scanner.ReadAll();
+
+    auto state = duckdb::make_uniq<VectorKMeansState>();
+    state->result = KMeans(bind_data.options).Run(data, GetNumberOfThreads(context));
+    state->keys = std::move(data.keys);
+    return std::move(state);
+}
+
+void VectorKMeans::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                           duckdb::DataChunk& output) {
+    const auto& bind_data = data.bind_data->Cast<VectorKMeansBindData>();
+    auto& state = data.global_state->Cast<VectorKMeansState>();
+    const auto& result = state.result;
+
+    if (bind_data.output_centroids) {
+        const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, result.cluster_sizes.size() - state.offset);
+        auto clusters = duckdb::FlatVector::GetData<int32_t>(output.data[0]);
+        auto sizes = duckdb::FlatVector::GetData<int64_t>(output.data[1]);
+        auto& centroids = output.data[2];
+        duckdb::ListVector::Reserve(centroids, count * result.dimensions);
+        auto entries = duckdb::FlatVector::GetData<duckdb::list_entry_t>(centroids);
+        auto values = duckdb::FlatVector::GetData<float>(duckdb::ListVector::GetEntry(centroids));
+        for (size_t i = 0; i < count; i++) {
+            const auto cluster = state.offset + i;
+            clusters[i] = static_cast<int32_t>(cluster);
+            sizes[i] = result.cluster_sizes[cluster];
+            entries[i] = duckdb::list_entry_t(i * result.dimensions, result.dimensions);
+            std::copy_n(result.centroids.data() + cluster * result.dimensions, result.dimensions,
+                        values + i * result.dimensions);
+        }
+        duckdb::ListVector::SetListSize(centroids, count * result.dimensions);
+        state.offset += count;
+        output.SetCardinality(count);
+        return;
+    }
+
+    const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, state.keys.size() - state.offset);
+    auto keys = duckdb::FlatVector::GetData<int64_t>(output.data[0]);
+    auto clusters = duckdb::FlatVector::GetData<int32_t>(output.data[1]);
+    auto distances = duckdb::FlatVector::GetData<float>(output.data[2]);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = state.keys[state.offset + i];
+        clusters[i] = static_cast<int32_t>(result.assignments[state.offset + i]);
+        distances[i] = result.distances[state.offset + i];
+    }
+    state.offset += count;
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,19 @@
+#include "flockmtl/functions/table/vector_kmeans.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterVectorKMeans(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("vector_kmeans",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::INTEGER},
+                                   VectorKMeans::Execute, VectorKMeans::Bind, VectorKMeans::Init);
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["max_iterations"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["batch_size"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["seed"] = duckdb::LogicalType::BIGINT;
+    function.named_parameters["output"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,78 @@
+#include "flockmtl/functions/table/vector_search_exact.hpp"
+
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct VectorSearchExactBindData : public duckdb::TableFunctionData {
+    EmbeddingSource source;
+    std::vector<std::vector<float>> queries;
+    size_t k;
+    VectorMetric metric;
+};
+
+struct VectorSearchExactState : public duckdb::GlobalTableFunctionState {
+    std::vector<ExactSearch::Result> results;
+    size_t query = 0;
+    size_t offset = 0;
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> VectorSearchExact::Bind(duckdb::ClientContext& context,
+                                                                 duckdb::TableFunctionBindInput& input,
+                                                                 duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                 duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorSearchExactBindData>();
+    bind_data->source.table_name = GetStringArgument(input.inputs[0], "table_name");
+    bind_data->source.key_column = GetStringArgument(input.inputs[1], "key_column");
+    bind_data->source.embedding_column = GetStringArgument(input.inputs[2], "embedding_column");
+    bind_data->queries = GetVectorsArgument(input.inputs[3], "query");
+    bind_data->k = GetCountArgument(input.inputs[4], "k");
+    bind_data->metric = GetMetricArgument(input.named_parameters, VectorMetric::COSINE);
+
+    return_types = {duckdb::LogicalType::INTEGER, duckdb::LogicalType::BIGINT, duckdb::LogicalType::FLOAT};
+    names = {"query_index", "row_key", "distance"};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> VectorSearchExact::Init(duckdb::ClientContext& context,
+                                                                             duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<VectorSearchExactBindData>();
+    auto con = Config::GetConnection();
+    EmbeddingScanner scanner(con, bind_data.source);
+    ExactSearch search(bind_data.metric, bind_data.queries, bind_data.k);
+
+    auto state = duckdb::make_uniq<VectorSearchExactState>();
+    state->results = search.Run(scanner, GetNumberOfThreads(context));
+    return std::move(state);
+}
+
+void VectorSearchExact::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<VectorSearchExactState>();
+    auto query_indexes = duckdb::FlatVector::GetData<int32_t>(output.data[0]);
+    auto keys = duckdb::FlatVector::GetData<int64_t>(output.data[1]);
+    auto distances = duckdb::FlatVector::GetData<float>(output.data[2]);
+
+    duckdb::idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE && state.query < state.results.size()) {
+        const auto& result = state.results[state.query];
+        if (state.offset == result.size()) {
+            state.query++;
+            state.offset = 0;
+            continue;
+        }
+        // Query indexes start at 1, like the positions of a DuckDB list
+        query_indexes[count] = static_cast<int32_t>(state.query + 1);
+        keys[count] = result[state.offset].first;
+        distances[count] = result[state.offset].second;
+        state.offset++;
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,16 @@
+#include "flockmtl/functions/table/vector_search_exact.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterVectorSearchExact(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("vector_search_exact",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::ANY,
+                                    duckdb::LogicalType::INTEGER},
+                                   VectorSearchExact::Execute, VectorSearchExact::Bind, VectorSearchExact::Init);
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,69 @@
+#include "flockmtl/functions/table/vector_search_rescore.hpp"
+
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct VectorSearchRescoreBindData : public duckdb::TableFunctionData {
+    EmbeddingSource source;
+    std::string quantized_column;
+    std::vector<float> query;
+    size_t k;
+    size_t oversample;
+    VectorMetric metric;
+};
+
+struct VectorSearchRescoreState : public duckdb::GlobalTableFunctionState {
+    ExactSearch::Result results;
+    size_t offset = 0;
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> VectorSearchRescore::Bind(duckdb::ClientContext& context,
+                                                                   duckdb::TableFunctionBindInput& input,
+                                                                   duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                   duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorSearchRescoreBindData>();
+    bind_data->source.table_name = GetStringArgument(input.inputs[0], "table_name");
+    bind_data->source.key_column = GetStringArgument(input.inputs[1], "key_column");
+    bind_data->quantized_column = GetStringArgument(input.inputs[2], "quantized_column");
+    bind_data->source.embedding_column = GetStringArgument(input.inputs[3], "embedding_column");
+    bind_data->query = GetVectorArgument(input.inputs[4], "query");
+    bind_data->k = GetCountArgument(input.inputs[5], "k");
+    bind_data->oversample = GetCountArgument(input.named_parameters, "oversample", default_oversample);
+    bind_data->metric = GetMetricArgument(input.named_parameters, VectorMetric::COSINE);
+
+    return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::FLOAT};
+    names = {"row_key", "distance"};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState> VectorSearchRescore::Init(duckdb::ClientContext& context,
+                                                                               duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<VectorSearchRescoreBindData>();
+    auto con = Config::GetConnection();
+    RescoreSearch search(bind_data.metric, bind_data.query, bind_data.k, bind_data.oversample);
+
+    auto state = duckdb::make_uniq<VectorSearchRescoreState>();
+    state->results = search.Run(con, bind_data.source, bind_data.quantized_column);
+    return std::move(state);
+}
+
+void VectorSearchRescore::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                  duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<VectorSearchRescoreState>();
+    const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, state.results.size() - state.offset);
+    auto keys = duckdb::FlatVector::GetData<int64_t>(output.data[0]);
+    auto distances = duckdb::FlatVector::GetData<float>(output.data[1]);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = state.results[state.offset + i].first;
+        distances[i] = state.results[state.offset + i].second;
+    }
+    state.offset += count;
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,17 @@
+#include "flockmtl/functions/table/vector_search_rescore.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterVectorSearchRescore(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("vector_search_rescore",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::ANY, duckdb::LogicalType::INTEGER},
+                                   VectorSearchRescore::Execute, VectorSearchRescore::Bind, VectorSearchRescore::Init);
+    function.named_parameters["oversample"] = duckdb::LogicalType::INTEGER;
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,85 @@
+#include "flockmtl/functions/table/vector_similarity_join.hpp"
+
+#include <cmath>
+
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+struct VectorSimilarityJoinBindData : public duckdb::TableFunctionData {
+    EmbeddingSource left;
+    EmbeddingSource right;
+    SimilarityJoinOptions options;
+};
+
+struct VectorSimilarityJoinState : public duckdb::GlobalTableFunctionState {
+    std::vector<SimilarityMatch> matches;
+    size_t offset = 0;
+};
+
+} // namespace
+
+duckdb::unique_ptr<duckdb::FunctionData> VectorSimilarityJoin::Bind(duckdb::ClientContext& context,
+                                                                    duckdb::TableFunctionBindInput& input,
+                                                                    duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                    duckdb::vector<duckdb::string>& names) {
+    auto bind_data = duckdb::make_uniq<VectorSimilarityJoinBindData>();
+    bind_data->left.table_name = GetStringArgument(input.inputs[0], "left_table");
+    bind_data->left.key_column = GetStringArgument(input.inputs[1], "left_key_column");
+    bind_data->left.embedding_column = GetStringArgument(input.inputs[2], "left_embedding_column");
+    bind_data->right.table_name = GetStringArgument(input.inputs[3], "right_table");
+    bind_data->right.key_column = GetStringArgument(input.inputs[4], "right_key_column");
+    bind_data->right.embedding_column = GetStringArgument(input.inputs[5], "right_embedding_column");
+
+    auto& options = bind_data->options;
+    options.metric = GetMetricArgument(input.named_parameters, options.metric);
+    options.k = GetCountArgument(input.named_parameters, "k", 0);
+    if (const auto max_distance = input.named_parameters.find("max_distance");
+        max_distance != input.named_parameters.end() && !max_distance->second.IsNull()) {
+        options.max_distance = max_distance->second.GetValue<float>();
+    }
+    if (options.k == 0 && std::isinf(options.max_distance)) {
+        throw std::runtime_error("vector_similarity_join requires `max_distance`, `k` or both, otherwise every pair "
+                                 "of rows is returned.");
+    }
+
+    return_types = {duckdb::LogicalType::BIGINT, duckdb::LogicalType::BIGINT, duckdb::LogicalType::FLOAT};
+    names = {"left_key", "right_key", "distance"};
+    return std::move(bind_data);
+}
+
+duckdb::unique_ptr<duckdb::GlobalTableFunctionState>
+VectorSimilarityJoin::Init(duckdb::ClientContext& context, duckdb::TableFunctionInitInput& input) {
+    const auto& bind_data = input.bind_data->Cast<VectorSimilarityJoinBindData>();
+    auto con = Config::GetConnection();
+
+    // The right side is held in memory and scored against the streamed left side
+    EmbeddingScanner right_scanner(con, bind_data.right);
+    SimilarityJoin join(right_scanner.ReadAll(), bind_data.options);
+    EmbeddingScanner left_scanner(con, bind_data.left);
+
+    auto state = duckdb::make_uniq<VectorSimilarityJoinState>();
+    state->matches = join.Run(left_scanner, GetNumberOfThreads(context));
+    return std::move(state);
+}
+
+void VectorSimilarityJoin::Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                                   duckdb::DataChunk& output) {
+    auto& state = data.global_state->Cast<VectorSimilarityJoinState>();
+    const auto count = std::min<size_t>(STANDARD_VECTOR_SIZE, state.matches.size() - state.offset);
+    auto left_keys = duckdb::FlatVector::GetData<int64_t>(output.data[0]);
+    auto right_keys = duckdb::FlatVector::GetData<int64_t>(output.data[1]);
+    auto distances = duckdb::FlatVector::GetData<float>(output.data[2]);
+    for (size_t i = 0; i < count; i++) {
+        const auto& match = state.matches[state.offset + i];
+        left_keys[i] = match.left_key;
+        right_keys[i] = match.right_key;
+        distances[i] = match.distance;
+    }
+    state.offset += count;
+    output.SetCardinality(count);
+}
+
+} // namespace flockmtl
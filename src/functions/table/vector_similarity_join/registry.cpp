@@ -0,0 +1,19 @@
+#include "flockmtl/functions/table/vector_similarity_join.hpp"
+#include "flockmtl/registry/registry.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::RegisterVectorSimilarityJoin(duckdb::DatabaseInstance& db) {
+    duckdb::TableFunction function("vector_similarity_join",
+                                   {duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR,
+                                    duckdb::LogicalType::VARCHAR, duckdb::LogicalType::VARCHAR},
+                                   VectorSimilarityJoin::Execute, VectorSimilarityJoin::Bind,
+                                   VectorSimilarityJoin::Init);
+    function.named_parameters["metric"] = duckdb::LogicalType::VARCHAR;
+    function.named_parameters["max_distance"] = duckdb::LogicalType::FLOAT;
+    function.named_parameters["k"] = duckdb::LogicalType::INTEGER;
+    duckdb::ExtensionUtil::RegisterFunction(db, function);
+}
+
+} // namespace flockmtl
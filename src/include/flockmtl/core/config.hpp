@@ -25,6 +25,9 @@ public:
     static std::string get_default_models_table_name();
     static std::string get_user_defined_models_table_name();
     static std::string get_prompts_table_name();
+    static std::string get_batch_jobs_table_name();
+    static std::string get_vector_indexes_table_name();
+    static std::string get_vector_index_nodes_table_name();
     constexpr static int32_t default_context_window = 128000;
     constexpr static int32_t default_max_output_tokens = 4096;
 
@@ -33,6 +36,8 @@ private:
     static void ConfigSchema(duckdb::Connection& con, std::string& schema_name);
     static void ConfigPromptTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
     static void ConfigModelTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
+    static void ConfigBatchJobTable(duckdb::Connection& con, std::string& schema_name, ConfigType type);
+    static void ConfigVectorIndexTables(duckdb::Connection& con, std::string& schema_name, ConfigType type);
     static void SetupDefaultModelsConfig(duckdb::Connection& con, std::string& schema_name);
     static void SetupUserDefinedModelsConfig(duckdb::Connection& con, std::string& schema_name);
 };
@@ -64,6 +64,7 @@ public:
     std::string ToSQL(const QueryStatement& statement) const;
 
 private:
+    static void ValidateModelArgs(const nlohmann::json& model_args);
     void ParseCreateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
     void ParseDeleteModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
     void ParseUpdateModel(Tokenizer& tokenizer, std::unique_ptr<QueryStatement>& statement);
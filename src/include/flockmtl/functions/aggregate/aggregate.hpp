@@ -18,6 +18,16 @@ public:
     void Combine(const AggregateFunctionState& source);
 };
 
+// Origin of the requests of an LLM aggregate, captured while binding since the aggregate callbacks get no
+// ClientContext
+struct AggregateBindData : public duckdb::FunctionData {
+    RequestOrigin origin;
+
+    explicit AggregateBindData(const RequestOrigin& origin) : origin(origin) {}
+    duckdb::unique_ptr<duckdb::FunctionData> Copy() const override;
+    bool Equals(const duckdb::FunctionData& other) const override;
+};
+
 class AggregateFunctionBase {
 public:
     Model model;
@@ -34,6 +44,11 @@ public:
 
     static bool IgnoreNull() { return true; };
 
+    // Captures the origin of the requests of the aggregate
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    Bind(duckdb::ClientContext& context, duckdb::AggregateFunction& function,
+         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+
     template <class Derived>
     static void Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p) {
         auto state_ptr = reinterpret_cast<AggregateFunctionState*>(state_p);
@@ -52,7 +67,8 @@ public:
 
         auto [model_details, prompt_details, tuples] = CastInputsToJson(inputs, count);
         auto function_instance = GetInstance<Derived>();
-        function_instance->model = Model(model_details);
+        function_instance->model =
+            Model(model_details, aggr_input_data.bind_data->Cast<AggregateBindData>().origin);
         function_instance->user_query = PromptManager::CreatePromptDetails(prompt_details).prompt;
 
         auto states_vector = duckdb::FlatVector::GetData<AggregateFunctionState*>(states);
@@ -72,7 +88,8 @@ public:
 
         auto [model_details, prompt_details, tuples] = CastInputsToJson(inputs, count);
         auto function_instance = GetInstance<Derived>();
-        function_instance->model = Model(model_details);
+        function_instance->model =
+            Model(model_details, aggr_input_data.bind_data->Cast<AggregateBindData>().origin);
         function_instance->user_query = PromptManager::CreatePromptDetails(prompt_details).prompt;
 
         auto state_map_p = reinterpret_cast<AggregateFunctionState*>(state_p);
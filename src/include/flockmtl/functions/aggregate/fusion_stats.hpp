@@ -0,0 +1,42 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+struct FusionStatsState {
+    int64_t count;
+    double min;
+    double max;
+    double mean;
+    // Sum of the squared differences to the mean, updated with Welford's algorithm
+    double m2;
+};
+
+// Aggregate computing the statistics the fusion_minmax and fusion_zscore functions normalize scores with. Used as a
+// window function, e.g. `fusion_stats(score) OVER ()`, it normalizes each score against the whole result.
+class FusionStats {
+public:
+    FusionStats() = delete;
+
+    // Fields of the returned struct, in order
+    enum Field : duckdb::idx_t { COUNT = 0, MIN, MAX, MEAN, STDDEV };
+    static duckdb::LogicalType GetResultType();
+
+    static void Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p);
+    static void Operation(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                          duckdb::Vector& states, idx_t count);
+    static void SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                             duckdb::data_ptr_t state_p, idx_t count);
+    static void Combine(duckdb::Vector& source, duckdb::Vector& target, duckdb::AggregateInputData& aggr_input_data,
+                        idx_t count);
+    static void Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, duckdb::Vector& result,
+                         idx_t count, idx_t offset);
+
+private:
+    static void Update(FusionStatsState& state, double value);
+    static void Merge(FusionStatsState& target, const FusionStatsState& source);
+    static void Write(const FusionStatsState& state, duckdb::Vector& result, idx_t row);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+struct VectorAggregateState {
+    int64_t count;
+    idx_t dimensions;
+    // `dimensions` running values allocated in the arena of the aggregate: double sums for the sum and means, float
+    // minimums or maximums for the element-wise extremes
+    duckdb::data_ptr_t values;
+};
+
+enum class VectorAggregateKind { SUM, MEAN, NORMALIZED_MEAN, MIN, MAX };
+
+// Element-wise aggregates over embeddings, e.g. the centroid of every group with `vector_mean(embedding)`. The rows
+// are folded into their state with the SIMD kernels, and the partial states of parallel aggregation are merged the
+// same way. The result has the type the input is cast to, FLOAT[N] for arrays and FLOAT[] for lists.
+class VectorAggregate {
+public:
+    VectorAggregate() = delete;
+
+    static duckdb::AggregateFunction GetFunction(const std::string& name, VectorAggregateKind kind);
+
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::AggregateFunction& function,
+                                                         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& args);
+    static void Initialize(const duckdb::AggregateFunction&, duckdb::data_ptr_t state_p);
+
+    template <VectorAggregateKind KIND>
+    static void Operation(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data, idx_t input_count,
+                          duckdb::Vector& states, idx_t count);
+    template <VectorAggregateKind KIND>
+    static void SimpleUpdate(duckdb::Vector inputs[], duckdb::AggregateInputData& aggr_input_data,
+                             idx_t input_count, duckdb::data_ptr_t state_p, idx_t count);
+    template <VectorAggregateKind KIND>
+    static void Combine(duckdb::Vector& source, duckdb::Vector& target, duckdb::AggregateInputData& aggr_input_data,
+                        idx_t count);
+    template <VectorAggregateKind KIND>
+    static void Finalize(duckdb::Vector& states, duckdb::AggregateInputData& aggr_input_data, duckdb::Vector& result,
+                         idx_t count, idx_t offset);
+
+private:
+    // Adds a vector `weight` times, a constant input being added once for the whole chunk
+    template <VectorAggregateKind KIND>
+    static void Update(VectorAggregateState& state, const float* data, idx_t size, int64_t weight,
+                       duckdb::ArenaAllocator& allocator);
+    template <VectorAggregateKind KIND>
+    static void Merge(VectorAggregateState& target, const VectorAggregateState& source,
+                      duckdb::ArenaAllocator& allocator);
+    template <VectorAggregateKind KIND>
+    static void Write(const VectorAggregateState& state, duckdb::Vector& result, idx_t row);
+
+    static void CheckDimensions(const VectorAggregateState& state, idx_t size);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+
+#include "flockmtl/model_manager/repository.hpp"
+#include "flockmtl/prompt_manager/repository.hpp"
+
+namespace flockmtl {
+
+// Learns how many tuples fit in one completion request for a given (model, function type) pair.
+// The state is shared by every query in the process so a model's output behaviour is only learned once.
+class BatchSizeController {
+public:
+    explicit BatchSizeController(int32_t max_output_tokens);
+
+    static std::shared_ptr<BatchSizeController> Get(const ModelDetails& model_details,
+                                                    ScalarFunctionType function_type);
+
+    // Upper bound on the number of tuples of the next batch, 0 when only the context window applies.
+    size_t GetBatchSize();
+    // Feeds the real number of output tokens a successful batch consumed back into the estimate.
+    void RecordSuccess(size_t batch_size, int32_t output_tokens);
+    // Bisects the failing batch; throws once a single tuple overflows the output budget.
+    void RecordOverflow(size_t batch_size);
+
+private:
+    constexpr static double output_tokens_headroom = 0.9;
+    constexpr static double smoothing_factor = 0.3;
+
+    std::mutex mutex_;
+    int32_t max_output_tokens_;
+    double output_tokens_per_tuple_;
+    size_t batch_size_;
+
+    static std::mutex registry_mutex_;
+    static std::map<std::string, std::shared_ptr<BatchSizeController>> registry_;
+};
+
+} // namespace flockmtl
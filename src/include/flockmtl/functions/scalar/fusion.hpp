@@ -0,0 +1,35 @@
+#pragma once
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+
+namespace flockmtl {
+
+// Score fusion functions for hybrid search. Each argument is the score (or rank) of a row in one result list; a NULL
+// argument means the row is missing from that list.
+class Fusion : public ScalarFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindWeighted(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                 duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+
+    static void ExecuteRelative(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteRrf(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteCombSum(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteCombMnz(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteWeighted(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    // Normalize a score with the statistics computed by the fusion_stats aggregate
+    static void ExecuteMinMax(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteZScore(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+
+    // Constant of reciprocal rank fusion, which dampens the weight of the top ranks
+    constexpr static double rrf_k = 60.0;
+
+private:
+    template <class OP>
+    static void ExecuteFusion(duckdb::DataChunk& args, duckdb::Vector& result, duckdb::idx_t first_score,
+                              const std::vector<double>& weights);
+    template <class OP>
+    static void ExecuteNormalize(duckdb::DataChunk& args, duckdb::Vector& result);
+};
+
+} // namespace flockmtl
@@ -1,14 +0,0 @@
-#pragma once
-
-#include "flockmtl/functions/scalar/scalar.hpp"
-
-namespace flockmtl {
-
-class FusionRelative : public ScalarFunctionBase {
-public:
-    static void ValidateArguments(duckdb::DataChunk& args);
-    static std::vector<double> Operation(duckdb::DataChunk& args);
-    static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
-};
-
-} // namespace flockmtl
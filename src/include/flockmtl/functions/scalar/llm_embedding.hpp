@@ -7,7 +7,10 @@ namespace flockmtl {
 class LlmEmbedding : public ScalarFunctionBase {
 public:
     static void ValidateArguments(duckdb::DataChunk& args);
-    static std::vector<duckdb::vector<duckdb::Value>> Operation(duckdb::DataChunk& args);
+    static std::vector<std::vector<float>> Operation(duckdb::DataChunk& args);
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::ScalarFunction& bound_function,
+                                                         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
     static void Execute(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
 };
 
@@ -8,6 +8,7 @@
 #include "flockmtl/model_manager/tiktoken.hpp"
 #include "flockmtl/prompt_manager/prompt_manager.hpp"
 #include "flockmtl/functions/batch_response_builder.hpp"
+#include "flockmtl/functions/batch_size_controller.hpp"
 
 namespace flockmtl {
 
@@ -24,6 +25,31 @@ public:
     static nlohmann::json BatchAndComplete(const std::vector<nlohmann::json>& tuples,
                                            const std::string& user_prompt_name, ScalarFunctionType function_type,
                                            Model& model);
+    // Tokens of the context window left for the tuples once the prompt and its template are counted
+    static int GetAvailableTokens(const std::string& user_prompt, ScalarFunctionType function_type, Model& model);
+    // The scalar functions only ever see one chunk, so offline execution would submit one batch job per chunk and
+    // wait for each in turn; `llm_map` submits the rows of the whole query as a single job instead
+    static void RejectOfflineExecution(Model& model, const std::string& function_name);
+
+private:
+    // Returns the end of the batch starting at `start_index`, bounded by `batch_size` (0 for unbounded) and the
+    // available context window
+    static size_t GetBatchEnd(const std::vector<nlohmann::json>& tuples, size_t start_index, size_t batch_size,
+                              int available_tokens);
+    // Streams the completion of a batch, appending its tuples to `responses` as they are generated; throws as soon
+    // as the model returns more tuples than the batch holds
+    static void CompleteStream(const nlohmann::json& tuples, const std::string& user_prompt,
+                               ScalarFunctionType function_type, Model& model, nlohmann::json& responses);
+    static nlohmann::json BatchAndCompleteOnline(const std::vector<nlohmann::json>& tuples,
+                                                 const std::string& user_prompt, ScalarFunctionType function_type,
+                                                 Model& model);
+    static nlohmann::json BatchAndCompleteOffline(const std::vector<nlohmann::json>& tuples,
+                                                  const std::string& user_prompt, ScalarFunctionType function_type,
+                                                  Model& model);
+
+    // Output tokens assumed per tuple to size offline batches. Offline batches never use the learned batch size, so
+    // that a re-run in another process renders the same requests and resumes the job already submitted.
+    constexpr static int32_t offline_output_tokens_per_tuple = 64;
 };
 
 } // namespace flockmtl
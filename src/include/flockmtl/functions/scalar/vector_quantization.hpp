@@ -0,0 +1,37 @@
+#pragma once
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+#include "flockmtl/vector/float_vector.hpp"
+#include "flockmtl/vector/quantizer.hpp"
+
+namespace flockmtl {
+
+class VectorQuantization : public ScalarFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindQuantizeInt8(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                     duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindQuantizeBinary(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                       duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindInt8Metric(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                   duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+
+    static void ExecuteQuantizeInt8(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteQuantizeBinary(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                      duckdb::Vector& result);
+    static void ExecuteInt8InnerProduct(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                        duckdb::Vector& result);
+    static void ExecuteInt8CosineSimilarity(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                            duckdb::Vector& result);
+    static void ExecuteHammingDistance(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                       duckdb::Vector& result);
+
+private:
+    template <class RESULT_TYPE, class OP>
+    static void ExecuteInt8Metric(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result,
+                                  OP&& operation);
+};
+
+} // namespace flockmtl
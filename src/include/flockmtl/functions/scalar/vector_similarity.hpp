@@ -0,0 +1,39 @@
+#pragma once
+
+#include "flockmtl/functions/scalar/scalar.hpp"
+#include "flockmtl/vector/float_vector.hpp"
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+class VectorSimilarity : public ScalarFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::ScalarFunction& bound_function,
+                                                         duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindTruncate(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                 duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+    static duckdb::unique_ptr<duckdb::FunctionData>
+    BindNormalize(duckdb::ClientContext& context, duckdb::ScalarFunction& bound_function,
+                  duckdb::vector<duckdb::unique_ptr<duckdb::Expression>>& arguments);
+
+    static void ExecuteCosineSimilarity(duckdb::DataChunk& args, duckdb::ExpressionState& state,
+                                        duckdb::Vector& result);
+    static void ExecuteInnerProduct(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteL2Distance(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteL1Distance(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteNormalize(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    static void ExecuteTruncate(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+
+private:
+    template <class OP>
+    static void ExecuteMetric(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result);
+    // Writes the input vectors scaled to unit length, keeping only their first `truncated_size` elements when it is
+    // not 0
+    static void WriteNormalized(duckdb::DataChunk& args, duckdb::ExpressionState& state, duckdb::Vector& result,
+                                duckdb::idx_t truncated_size);
+    static void CheckDimensions(const std::string& function_name, duckdb::idx_t left_size, duckdb::idx_t right_size);
+};
+
+} // namespace flockmtl
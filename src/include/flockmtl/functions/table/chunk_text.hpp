@@ -0,0 +1,27 @@
+#pragma once
+
+#include "flockmtl/functions/table/table.hpp"
+
+namespace flockmtl {
+
+// Table in-out function splitting long texts into overlapping chunks of at most `max_tokens` tokens, counted with
+// the tokenizer the request batching uses, so that every chunk fits the context of the embedding model. Documents
+// are split while they stream through, one chunk at a time.
+class ChunkText : public TableFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState> InitLocal(duckdb::ExecutionContext& context,
+                                                                         duckdb::TableFunctionInitInput& input,
+                                                                         duckdb::GlobalTableFunctionState* state);
+    static duckdb::OperatorResultType Execute(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                              duckdb::DataChunk& input, duckdb::DataChunk& output);
+
+    constexpr static size_t default_max_tokens = 512;
+    // The default overlap is `max_tokens / default_overlap_divisor` tokens
+    constexpr static size_t default_overlap_divisor = 8;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "flockmtl/functions/table/table.hpp"
+
+namespace flockmtl {
+
+// Table in-out variant of `llm_complete`, `llm_complete_json` and `llm_filter`. The scalar functions only ever see
+// one chunk, so after a selective filter they send many small requests that each pay the whole prompt. This one
+// buffers its input rows across chunks until a batch fills the context window and sends the batch in the background,
+// up to `max_in_flight` at once, so that the upstream operators keep producing chunks while the model answers. Every
+// input row is emitted with its response in input order, and the input is only paused once more than
+// `max_outstanding_chunks` chunks wait for their responses.
+class LlmMap : public TableFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::LocalTableFunctionState> InitLocal(duckdb::ExecutionContext& context,
+                                                                         duckdb::TableFunctionInitInput& input,
+                                                                         duckdb::GlobalTableFunctionState* state);
+    static duckdb::OperatorResultType Execute(duckdb::ExecutionContext& context, duckdb::TableFunctionInput& data,
+                                              duckdb::DataChunk& input, duckdb::DataChunk& output);
+    // Completes the rows still buffered once the input is exhausted
+    static duckdb::OperatorFinalizeResultType Finalize(duckdb::ExecutionContext& context,
+                                                       duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+
+    constexpr static size_t default_max_in_flight = 4;
+    constexpr static size_t default_max_outstanding_chunks = 64;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/vector/metric.hpp"
+
+namespace flockmtl {
+
+// Argument handling shared by the table functions; their arguments are constants read once at bind time
+class TableFunctionBase {
+public:
+    TableFunctionBase() = delete;
+
+    static std::string GetStringArgument(const duckdb::Value& value, const std::string& argument);
+    static size_t GetCountArgument(const duckdb::Value& value, const std::string& argument);
+    static size_t GetCountArgument(const duckdb::named_parameter_map_t& named_parameters, const std::string& argument,
+                                   size_t default_value);
+    static VectorMetric GetMetricArgument(const duckdb::named_parameter_map_t& named_parameters,
+                                          VectorMetric default_value);
+    // Reads a FLOAT[N] array or a numeric list
+    static std::vector<float> GetVectorArgument(const duckdb::Value& value, const std::string& argument);
+    // Reads either a single vector or a list of vectors
+    static std::vector<std::vector<float>> GetVectorsArgument(const duckdb::Value& value, const std::string& argument);
+
+    static size_t GetNumberOfThreads(duckdb::ClientContext& context);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "flockmtl/functions/table/table.hpp"
+#include "flockmtl/vector/vector_index.hpp"
+
+namespace flockmtl {
+
+class VectorIndexFunctions : public TableFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> BindCreate(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::FunctionData> BindRefresh(duckdb::ClientContext& context,
+                                                                duckdb::TableFunctionBindInput& input,
+                                                                duckdb::vector<duckdb::LogicalType>& return_types,
+                                                                duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::FunctionData> BindDrop(duckdb::ClientContext& context,
+                                                             duckdb::TableFunctionBindInput& input,
+                                                             duckdb::vector<duckdb::LogicalType>& return_types,
+                                                             duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::FunctionData> BindSearch(duckdb::ClientContext& context,
+                                                               duckdb::TableFunctionBindInput& input,
+                                                               duckdb::vector<duckdb::LogicalType>& return_types,
+                                                               duckdb::vector<duckdb::string>& names);
+
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitOperation(duckdb::ClientContext& context,
+                                                                              duckdb::TableFunctionInitInput& input);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> InitSearch(duckdb::ClientContext& context,
+                                                                           duckdb::TableFunctionInitInput& input);
+
+    static void ExecuteCreate(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                              duckdb::DataChunk& output);
+    static void ExecuteRefresh(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                               duckdb::DataChunk& output);
+    static void ExecuteDrop(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                            duckdb::DataChunk& output);
+    static void ExecuteSearch(duckdb::ClientContext& context, duckdb::TableFunctionInput& data,
+                              duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "flockmtl/functions/table/table.hpp"
+#include "flockmtl/vector/kmeans.hpp"
+
+namespace flockmtl {
+
+class VectorKMeans : public TableFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> Init(duckdb::ClientContext& context,
+                                                                     duckdb::TableFunctionInitInput& input);
+    static void Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+
+    constexpr static size_t default_max_iterations = 25;
+    // Mini-batch iterations only see `batch_size` rows each, so they need many more of them
+    constexpr static size_t default_mini_batch_iterations = 100;
+    constexpr static int64_t default_seed = 42;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "flockmtl/functions/table/table.hpp"
+#include "flockmtl/vector/exact_search.hpp"
+
+namespace flockmtl {
+
+class VectorSearchExact : public TableFunctionBase {
+public:
+    static duckdb::unique_ptr<duckdb::FunctionData> Bind(duckdb::ClientContext& context,
+                                                         duckdb::TableFunctionBindInput& input,
+                                                         duckdb::vector<duckdb::LogicalType>& return_types,
+                                                         duckdb::vector<duckdb::string>& names);
+    static duckdb::unique_ptr<duckdb::GlobalTableFunctionState> Init(duckdb::ClientContext& context,
+                                                                     duckdb::TableFunctionInitInput& input);
+    static void Execute(duckdb::ClientContext& context, duckdb::TableFunctionInput& data, duckdb::DataChunk& output);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "flockmtl/model_manager/providers/provider.hpp"
+
+namespace flockmtl {
+
+// Runs a set of requests through the provider's offline batch endpoint. The job state is stored in
+// `flockmtl_config`, so running the same requests again resumes the submitted job instead of paying twice. The
+// requests an expired job did not complete are sent again in a new job.
+class BatchJob {
+public:
+    BatchJob(IProvider& provider, std::string endpoint, int32_t poll_interval_seconds);
+
+    // Returns the response bodies in request order; failed requests are returned as `{"error": ...}`.
+    std::vector<nlohmann::json> Run(const std::vector<nlohmann::json>& request_bodies);
+
+    constexpr static auto CHAT_COMPLETIONS_ENDPOINT = "/v1/chat/completions";
+
+private:
+    IProvider& provider_;
+    std::string endpoint_;
+    int32_t poll_interval_seconds_;
+
+    std::string GetJobKey(const std::string& requests_jsonl) const;
+    // Batch already submitted for the job, empty when there is none or it failed
+    std::string FindBatch(const std::string& job_key) const;
+    std::string Submit(const std::string& job_key, const std::string& requests_jsonl);
+    nlohmann::json WaitForCompletion(const std::string& job_key, const std::string& batch_id);
+    void CollectResults(const std::string& file_id, std::vector<nlohmann::json>& results);
+
+    static bool IsTerminalFailure(const std::string& status);
+    void SaveState(const std::string& job_key, const std::string& batch_id, const std::string& status,
+                   const std::string& output_file_id) const;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "flockmtl/model_manager/response_parser.hpp"
+
+namespace flockmtl {
+
+// Incremental parser of the `{"tuples": [...]}` responses the tuple prompts ask for. It is fed the generated text
+// as it streams in, hands every element of the array to `on_tuple` as soon as it closes, and throws as soon as the
+// text cannot be such a response, so that a malformed generation is aborted instead of running to the end.
+class TupleStreamParser {
+public:
+    explicit TupleStreamParser(std::function<void(nlohmann::json)> on_tuple);
+
+    void Feed(std::string_view text);
+    // Throws when the array of tuples was not closed
+    void CheckComplete() const;
+
+private:
+    std::function<void(nlohmann::json)> on_tuple_;
+    // Open objects and arrays, innermost last
+    std::vector<char> nesting_;
+    bool in_string_ = false;
+    bool escaped_ = false;
+    // Last string read inside the root object, the key of the value that follows it
+    std::string last_string_;
+    bool in_tuples_ = false;
+    bool tuples_closed_ = false;
+    // Text of the tuple being read
+    std::string tuple_;
+
+    void Consume(char c);
+    void EmitTuple();
+    [[noreturn]] static void ThrowMalformed(const std::string& reason);
+};
+
+// Consumes the body of a streamed completion of a tuple prompt: server-sent events of chat completion chunks for
+// OpenAI and Azure, newline-delimited JSON for Ollama. The body can be fed in pieces split anywhere.
+class CompletionStream {
+public:
+    enum class Format { SERVER_SENT_EVENTS, NDJSON };
+
+    CompletionStream(Format format, std::function<void(nlohmann::json)> on_tuple);
+
+    void Feed(const char* data, size_t size);
+    // Flushes the end of the body and returns how the generation ended, as reported by the last events; the
+    // content is not kept, it was handed over tuple by tuple
+    const CompletionResponse& Finish();
+    // Throws when the generated text did not contain a complete array of tuples
+    void CheckComplete() const { tuples_.CheckComplete(); }
+
+private:
+    Format format_;
+    TupleStreamParser tuples_;
+    CompletionResponse result_;
+    // Incomplete line at the end of the fed data
+    std::string line_;
+    // Data lines of the current server-sent event
+    std::string event_data_;
+
+    void ProcessLine(std::string_view line);
+    void ProcessEvent(const std::string& payload);
+};
+
+} // namespace flockmtl
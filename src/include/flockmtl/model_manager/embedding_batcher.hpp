@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace flockmtl {
+
+struct EmbeddingBatchLimits {
+    // Maximum number of inputs and tokens in a single request, 0 for unbounded
+    size_t max_items;
+    int64_t max_tokens;
+    // Maximum number of requests in flight at the same time
+    size_t max_concurrency;
+};
+
+// Splits the inputs of an embedding call into requests that fit the provider's limits and sends them concurrently.
+class EmbeddingBatcher {
+public:
+    using EmbedFunction = std::function<std::vector<std::vector<float>>(const std::vector<std::string>&)>;
+
+    // Returns the embeddings in input order; `embed` must return one embedding per input it receives, and is called
+    // from several threads at once.
+    static std::vector<std::vector<float>> Run(const std::vector<std::string>& inputs,
+                                               const EmbeddingBatchLimits& limits, const EmbedFunction& embed);
+    // Returns the [start, end) ranges of the sub-batches.
+    static std::vector<std::pair<size_t, size_t>> Split(const std::vector<std::string>& inputs,
+                                                        const EmbeddingBatchLimits& limits);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace flockmtl {
+
+// Turns the embeddings returned by the providers into float buffers.
+class EmbeddingDecoder {
+public:
+    // Decodes an embedding returned as a JSON array of numbers, or as a base64 string of little-endian float32
+    // values when the request asked for `encoding_format: base64`.
+    static std::vector<float> Decode(const nlohmann::json& embedding);
+    static std::vector<float> DecodeBase64(const std::string& encoded);
+};
+
+} // namespace flockmtl
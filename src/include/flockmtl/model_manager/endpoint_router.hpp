@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flockmtl/model_manager/providers/provider.hpp"
+
+namespace flockmtl {
+
+// Spreads the requests of a model over the endpoints of its secret pool. Every request goes to the endpoint with the
+// lowest expected wait, estimated from its requests in flight, its observed latency and the quota left in its rate
+// limiter. Ejected endpoints are only picked once all the others were tried.
+class EndpointRouter {
+public:
+    // Counts a request in flight on an endpoint, and records its latency once it completes
+    class Lease {
+    public:
+        explicit Lease(const ModelDetails& model_details);
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        // Keeps a failed request out of the latency of the endpoint
+        void Fail() { failed_ = true; }
+
+    private:
+        std::string key_;
+        std::chrono::steady_clock::time_point start_;
+        bool failed_ = false;
+    };
+
+    // Index of the endpoint the next request is sent to, among those not `tried` yet
+    static size_t Select(const std::vector<std::shared_ptr<IProvider>>& endpoints, const std::vector<bool>& tried);
+
+private:
+    struct EndpointStats {
+        size_t in_flight = 0;
+        // Moving average of the latency of the successful requests, 0 until the first one completes
+        double latency_ms = 0;
+    };
+
+    constexpr static double latency_smoothing = 0.2;
+    // Endpoints out of quota still get a finite cost, so that they are picked when all the others are ejected
+    constexpr static double min_headroom = 0.01;
+
+    static std::mutex mutex_;
+    static std::map<std::string, EndpointStats> stats_;
+    static size_t next_;
+};
+
+} // namespace flockmtl
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -9,6 +10,9 @@
 
 #include "flockmtl/core/config.hpp"
 #include "flockmtl/model_manager/repository.hpp"
+#include "flockmtl/model_manager/batch_job.hpp"
+#include "flockmtl/model_manager/endpoint_router.hpp"
+#include "flockmtl/model_manager/request_scheduler.hpp"
 #include "flockmtl/model_manager/providers/adapters/openai.hpp"
 #include "flockmtl/model_manager/providers/adapters/azure.hpp"
 #include "flockmtl/model_manager/providers/adapters/ollama.hpp"
@@ -20,18 +24,46 @@ namespace flockmtl {
 class Model {
 public:
     explicit Model(const nlohmann::json& model_json);
+    // Schedules the requests for `origin` instead of the origin of the thread creating the model
+    Model(const nlohmann::json& model_json, const RequestOrigin& origin);
     explicit Model() = default;
     nlohmann::json CallComplete(const std::string& prompt, const bool json_response = true);
-    nlohmann::json CallEmbedding(const std::vector<std::string>& inputs);
+    std::vector<std::vector<float>> CallEmbedding(const std::vector<std::string>& inputs);
+    // Completes a tuple prompt, handing every tuple of the response to `on_tuple` as soon as it is generated
+    void CallCompleteStream(const std::string& prompt, const std::function<void(nlohmann::json)>& on_tuple);
+    // Completes all the prompts in one offline batch job; prompts whose response overflowed max_output_tokens are
+    // returned as null
+    std::vector<nlohmann::json> CallCompleteOffline(const std::vector<std::string>& prompts,
+                                                    const bool json_response = true);
     ModelDetails GetModelDetails();
+    // Usage of the last completion made by the calling thread, whichever endpoint of the pool answered it
+    TokenUsage GetLastUsage();
+    EmbeddingBatchLimits GetEmbeddingBatchLimits();
 
 private:
     std::shared_ptr<IProvider> provider_;
+    // One provider per secret of the pool, the first one being `provider_`
+    std::vector<std::shared_ptr<IProvider>> providers_;
+    std::vector<std::string> secret_names_;
     ModelDetails model_details_;
+    // Query the requests of the model are scheduled for, taken from the thread that created it
+    RequestOrigin origin_;
     void ConstructProvider();
+    static std::shared_ptr<IProvider> CreateProvider(const ModelDetails& model_details);
+    // Sends an online call to the endpoint picked by the router, failing over to the next one when it gets ejected
+    void CallRouted(const std::function<void(IProvider&)>& call, bool failover = true);
     void LoadModelDetails(const nlohmann::json& model_json);
-    std::tuple<std::string, std::string, int32_t, int32_t> GetQueriedModel(const std::string& model_name);
+    void LoadSecrets(const nlohmann::json& model_json, const nlohmann::json& model_args);
+    void LoadRetryPolicy(const nlohmann::json& model_json, const nlohmann::json& model_args);
+    void LoadRateLimits(const nlohmann::json& model_json, const nlohmann::json& model_args);
+    void LoadExecutionMode(const nlohmann::json& model_json, const nlohmann::json& model_args);
+    void LoadDimensions(const nlohmann::json& model_json, const nlohmann::json& model_args);
+    static nlohmann::json GetModelArgument(const nlohmann::json& model_json, const nlohmann::json& model_args,
+                                           const std::string& key);
+    std::tuple<std::string, std::string, nlohmann::json> GetQueriedModel(const std::string& model_name);
     std::string GetSecret(const std::string& secret_name);
+
+    constexpr static int32_t default_batch_poll_interval_seconds = 30;
 };
 
 } // namespace flockmtl
@@ -10,7 +10,15 @@ public:
     AzureProvider(const ModelDetails &model_details) : IProvider(model_details) {}
 
     nlohmann::json CallComplete(const std::string &prompt, bool json_response) override;
-    nlohmann::json CallEmbedding(const std::vector<std::string> &inputs) override;
+    void CallCompleteStream(const std::string &prompt,
+                            const std::function<void(nlohmann::json)> &on_tuple) override;
+    std::vector<std::vector<float>> CallEmbedding(const std::vector<std::string> &inputs) override;
+    // 2048 inputs and 300k tokens per request, the token budget leaves room for the approximate token count
+    EmbeddingBatchLimits GetEmbeddingBatchLimits() const override { return {2048, 240000, 8}; }
+
+private:
+    std::unique_ptr<AzureModelManager> CreateClient();
+    nlohmann::json GetCompletionRequest(const std::string &prompt, bool json_response) const;
 };
 
 } // namespace flockmtl
@@ -10,7 +10,14 @@ public:
     OllamaProvider(const ModelDetails &model_details) : IProvider(model_details) {}
 
     nlohmann::json CallComplete(const std::string &prompt, bool json_response) override;
-    nlohmann::json CallEmbedding(const std::vector<std::string> &inputs) override;
+    void CallCompleteStream(const std::string &prompt,
+                            const std::function<void(nlohmann::json)> &on_tuple) override;
+    std::vector<std::vector<float>> CallEmbedding(const std::vector<std::string> &inputs) override;
+    // Ollama truncates every input to the model context on its own, the budget only keeps requests reasonably sized
+    EmbeddingBatchLimits GetEmbeddingBatchLimits() const override { return {256, 16384, 4}; }
+
+private:
+    nlohmann::json GetCompletionRequest(const std::string &prompt, bool json_response, bool stream) const;
 };
 
 } // namespace flockmtl
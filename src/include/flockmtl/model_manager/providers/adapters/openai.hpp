@@ -10,7 +10,21 @@ public:
     OpenAIProvider(const ModelDetails &model_details) : IProvider(model_details) {}
 
     nlohmann::json CallComplete(const std::string &prompt, bool json_response) override;
-    nlohmann::json CallEmbedding(const std::vector<std::string> &inputs) override;
+    void CallCompleteStream(const std::string &prompt,
+                            const std::function<void(nlohmann::json)> &on_tuple) override;
+    std::vector<std::vector<float>> CallEmbedding(const std::vector<std::string> &inputs) override;
+    // 2048 inputs and 300k tokens per request, the token budget leaves room for the approximate token count
+    EmbeddingBatchLimits GetEmbeddingBatchLimits() const override { return {2048, 240000, 8}; }
+
+    nlohmann::json GetCompletionPayload(const std::string &prompt, bool json_response) override;
+    nlohmann::json ParseCompletion(const nlohmann::json &completion, bool json_response) override;
+    std::string SubmitBatch(const std::string &requests_file_path, const std::string &endpoint) override;
+    nlohmann::json RetrieveBatch(const std::string &batch_id) override;
+    std::string DownloadFile(const std::string &file_id) override;
+
+private:
+    std::unique_ptr<openai::OpenAI> CreateClient();
+    nlohmann::json GetEmbeddingPayload(const std::vector<std::string> &inputs) const;
 };
 
 } // namespace flockmtl
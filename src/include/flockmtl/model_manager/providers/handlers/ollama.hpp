@@ -2,6 +2,7 @@
 #define _FLOCK_MTL_MODEL_MANAGER_OLLAMA_H
 
 #include "session.hpp"
+#include "flockmtl/model_manager/response_parser.hpp"
 
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -21,7 +22,7 @@ public:
 
     std::string GetChatUrl() { return _url + "/api/generate"; }
 
-    std::string GetEmbedUrl() { return _url + "/api/embeddings"; }
+    std::string GetEmbedUrl() { return _url + "/api/embed"; }
 
     std::string GetAvailableOllamaModelsUrl() {
         static int check_done = -1;
@@ -39,18 +40,48 @@ public:
         return url;
     }
 
+    void setRetryPolicy(const RetryPolicy& retry_policy) { _session.setRetryPolicy(retry_policy); }
+
+    void setRateLimiter(std::shared_ptr<RateLimiter> rate_limiter, int64_t request_cost) {
+        _session.setRateLimiter(std::move(rate_limiter), request_cost);
+    }
+
     nlohmann::json CallComplete(const nlohmann::json& json, const std::string& contentType = "application/json") {
         std::string url = GetChatUrl();
         _session.setUrl(url);
         return execute_post(json.dump(), contentType);
     }
 
+    // Reads the completion with `parser` in a single pass instead of returning its document
+    void CallComplete(const nlohmann::json& json, ResponseParser& parser,
+                      const std::string& contentType = "application/json") {
+        std::string url = GetChatUrl();
+        _session.setUrl(url);
+        execute_post(json.dump(), contentType, parser);
+    }
+
+    // Streams the completion as newline-delimited JSON, `json` must request it with "stream": true
+    void CallCompleteStream(const nlohmann::json& json, const std::function<void(const char*, size_t)>& consumer,
+                            const std::string& contentType = "application/json") {
+        std::string url = GetChatUrl();
+        _session.setUrl(url);
+        execute_post_stream(json.dump(), contentType, consumer);
+    }
+
     nlohmann::json CallEmbedding(const nlohmann::json& json, const std::string& contentType = "application/json") {
         std::string url = GetEmbedUrl();
         _session.setUrl(url);
         return execute_post(json.dump(), contentType);
     }
 
+    // Reads the embeddings with `parser` in a single pass instead of returning their document
+    void CallEmbedding(const nlohmann::json& json, ResponseParser& parser,
+                       const std::string& contentType = "application/json") {
+        std::string url = GetEmbedUrl();
+        _session.setUrl(url);
+        execute_post(json.dump(), contentType, parser);
+    }
+
     bool validModel(const std::string& user_model_name) {
         std::string url = GetAvailableOllamaModelsUrl();
         auto response = _session.validOllamaModelsJson(url);
@@ -77,18 +108,41 @@ private:
             trigger_error(response.error_message);
         }
 
-        nlohmann::json json {};
-        if (isJson(response.text)) {
-
-            json = nlohmann::json::parse(response.text);
-            checkResponse(json);
-        } else {
+        auto json = nlohmann::json::parse(response.text, nullptr, false);
+        if (json.is_discarded()) {
             trigger_error("Response is not a valid JSON");
+            return {};
         }
+        checkResponse(json);
 
         return json;
     }
 
+    void execute_post(const std::string& data, const std::string& contentType, ResponseParser& parser) {
+        setParameters(data, contentType);
+        auto response = _session.postPrepareOllama(contentType);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+
+        if (!parser.Parse(response.text)) {
+            trigger_error("Response is not a valid JSON");
+        } else if (parser.HasError()) {
+            checkResponse(nlohmann::json::parse(response.text));
+        }
+    }
+
+    void execute_post_stream(const std::string& data, const std::string& contentType,
+                             const std::function<void(const char*, size_t)>& consumer) {
+        setParameters(data, contentType);
+        _session.setStreamConsumer(consumer);
+        auto response = _session.postPrepareOllama(contentType);
+        _session.setStreamConsumer(nullptr);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+    }
+
     void trigger_error(const std::string& msg) {
         if (_throw_exception) {
             throw std::runtime_error(msg);
@@ -105,16 +159,6 @@ private:
         }
     }
 
-    bool isJson(const std::string& data) {
-        bool rc = true;
-        try {
-            auto json = nlohmann::json::parse(data); // throws if no json
-        } catch (std::exception&) {
-            rc = false;
-        }
-        return (rc);
-    }
-
     void setParameters(const std::string& data, const std::string& contentType = "") {
         if (contentType != "multipart/form-data") {
             _session.setBody(data);
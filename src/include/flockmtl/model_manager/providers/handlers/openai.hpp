@@ -34,6 +34,7 @@
 #include <stdexcept>
 #include <string>
 #include "session.hpp"
+#include "flockmtl/model_manager/response_parser.hpp"
 #include <nlohmann/json.hpp> // nlohmann/json
 
 namespace openai {
@@ -131,6 +132,10 @@ private:
 // Given a prompt, the model will return one or more predicted chat completions.
 struct CategoryChat {
     Json create(Json input);
+    // Reads the completion with `parser` instead of returning its document
+    void create(Json input, flockmtl::ResponseParser &parser);
+    // Streams the completion, `input` must request it with "stream": true
+    void createStream(Json input, const std::function<void(const char *, size_t)> &consumer);
 
     CategoryChat(OpenAI &openai) : openai_ {openai} {}
 
@@ -180,6 +185,8 @@ private:
 // machine learning models and algorithms.
 struct CategoryEmbedding {
     Json create(Json input);
+    // Reads the embeddings with `parser` instead of returning their document
+    void create(Json input, flockmtl::ResponseParser &parser);
     CategoryEmbedding(OpenAI &openai) : openai_ {openai} {}
 
 private:
@@ -200,6 +207,7 @@ struct CategoryFile {
     Json del(const std::string &file); // TODO
     Json retrieve(const std::string &file_id);
     Json content(const std::string &file_id);
+    std::string download(const std::string &file_id);
 
     CategoryFile(OpenAI &openai) : openai_ {openai} {}
 
@@ -236,6 +244,20 @@ private:
     OpenAI &openai_;
 };
 
+// https://platform.openai.com/docs/api-reference/batch
+// Create large batches of API requests for asynchronous processing.
+struct CategoryBatch {
+    Json create(Json input);
+    Json retrieve(const std::string &batch_id);
+    Json cancel(const std::string &batch_id);
+    Json list();
+
+    CategoryBatch(OpenAI &openai) : openai_ {openai} {}
+
+private:
+    OpenAI &openai_;
+};
+
 // OpenAI
 class OpenAI {
 public:
@@ -255,7 +277,8 @@ public:
                 base_url = "https://api.openai.com/v1/";
             }
         } else {
-            base_url = api_base_url;
+            // Endpoint paths are appended to the base URL, which may be given with or without its trailing slash
+            base_url = api_base_url.back() == '/' ? api_base_url : api_base_url + "/";
         }
         session_.setUrl(base_url);
         session_.setToken(token_, organization_);
@@ -291,6 +314,12 @@ public:
 
     void setBeta(const std::string &beta) { session_.setBeta(beta); }
 
+    void setRetryPolicy(const flockmtl::RetryPolicy &retry_policy) { session_.setRetryPolicy(retry_policy); }
+
+    void setRateLimiter(std::shared_ptr<flockmtl::RateLimiter> rate_limiter, int64_t request_cost) {
+        session_.setRateLimiter(std::move(rate_limiter), request_cost);
+    }
+
     // void change_token(const std::string& token) { token_ = token; };
     void setThrowException(bool throw_exception) { throw_exception_ = throw_exception; }
 
@@ -306,21 +335,49 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
             std::cerr << "Response is not a valid JSON";
             std::cout << "<< " << response.text << "\n";
 #endif
+            json = Json {};
         }
 
         return json;
     }
 
+    // Posts `json` and reads the response with `parser` in a single pass, without building a document
+    void post(const std::string &suffix, const Json &json, flockmtl::ResponseParser &parser) {
+        const auto data = json.dump();
+        setParameters(suffix, data, "application/json");
+        auto response = session_.postPrepare("application/json");
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+
+        if (!parser.Parse(response.text)) {
+            trigger_error("Response is not a valid JSON");
+        } else if (parser.HasError()) {
+            checkResponse(Json::parse(response.text));
+        }
+    }
+
+    // Posts `json` and hands the response body to `consumer` as it streams in
+    void postStream(const std::string &suffix, const Json &json,
+                    const std::function<void(const char *, size_t)> &consumer) {
+        const auto data = json.dump();
+        setParameters(suffix, data, "application/json");
+        session_.setStreamConsumer(consumer);
+        auto response = session_.postPrepare("application/json");
+        session_.setStreamConsumer(nullptr);
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+    }
+
     Json get(const std::string &suffix, const std::string &data = "") {
         setParameters(suffix, data);
         auto response = session_.getPrepare();
@@ -328,9 +385,8 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
@@ -342,6 +398,15 @@ public:
         return json;
     }
 
+    std::string getText(const std::string &suffix) {
+        setParameters(suffix, "");
+        auto response = session_.getPrepare();
+        if (response.is_error) {
+            trigger_error(response.error_message);
+        }
+        return response.text;
+    }
+
     Json post(const std::string &suffix, const Json &json, const std::string &contentType = "application/json") {
         return post(suffix, json.dump(), contentType);
     }
@@ -353,15 +418,15 @@ public:
             trigger_error(response.error_message);
         }
 
-        Json json {};
-        if (isJson(response.text)) {
-            json = Json::parse(response.text);
+        auto json = Json::parse(response.text, nullptr, false);
+        if (!json.is_discarded()) {
             checkResponse(json);
         } else {
 #if OPENAI_VERBOSE_OUTPUT
             std::cerr << "Response is not a valid JSON\n";
             std::cout << "<< " << response.text << "\n";
 #endif
+            json = Json {};
         }
         return json;
     }
@@ -401,17 +466,6 @@ private:
         }
     }
 
-    // as of now the only way
-    bool isJson(const std::string &data) {
-        bool rc = true;
-        try {
-            auto json = Json::parse(data); // throws if no json
-        } catch (std::exception &) {
-            rc = false;
-        }
-        return (rc);
-    }
-
     void trigger_error(const std::string &msg) {
         if (throw_exception_) {
             throw std::runtime_error(msg);
@@ -431,6 +485,7 @@ public:
     CategoryFile file {*this};
     CategoryFineTune fine_tune {*this};
     CategoryModeration moderation {*this};
+    CategoryBatch batch {*this};
     CategoryChat chat {*this};
     CategoryAudio audio {*this};
     // CategoryEngine          engine{*this}; // Not handled since deprecated (use
@@ -671,6 +726,14 @@ inline Json CategoryCompletion::create(Json input) { return openai_.post("comple
 // Creates a chat completion for the provided prompt and parameters
 inline Json CategoryChat::create(Json input) { return openai_.post("chat/completions", input); }
 
+inline void CategoryChat::create(Json input, flockmtl::ResponseParser &parser) {
+    openai_.post("chat/completions", input, parser);
+}
+
+inline void CategoryChat::createStream(Json input, const std::function<void(const char *, size_t)> &consumer) {
+    openai_.postStream("chat/completions", input, consumer);
+}
+
 // POST https://api.openai.com/v1/audio/transcriptions
 // Transcribes audio into the input language.
 inline Json CategoryAudio::transcribe(Json input) {
@@ -797,6 +860,10 @@ inline Json CategoryImage::variation(Json input) {
 
 inline Json CategoryEmbedding::create(Json input) { return openai_.post("embeddings", input); }
 
+inline void CategoryEmbedding::create(Json input, flockmtl::ResponseParser &parser) {
+    openai_.post("embeddings", input, parser);
+}
+
 inline Json CategoryFile::list() { return openai_.get("files"); }
 
 inline Json CategoryFile::upload(Json input) {
@@ -812,6 +879,12 @@ inline Json CategoryFile::retrieve(const std::string &file_id) { return openai_.
 
 inline Json CategoryFile::content(const std::string &file_id) { return openai_.get("files/" + file_id + "/content"); }
 
+// GET https://api.openai.com/v1/files/{file_id}/content
+// Returns the raw contents of the file, e.g. the JSONL output of a batch.
+inline std::string CategoryFile::download(const std::string &file_id) {
+    return openai_.getText("files/" + file_id + "/content");
+}
+
 inline Json CategoryFineTune::create(Json input) { return openai_.post("fine-tunes", input); }
 
 inline Json CategoryFineTune::list() { return openai_.get("fine-tunes"); }
@@ -836,6 +909,24 @@ inline Json CategoryFineTune::del(const std::string &model) { return openai_.del
 
 inline Json CategoryModeration::create(Json input) { return openai_.post("moderations", input); }
 
+// POST https://api.openai.com/v1/batches
+// Creates and executes a batch from an uploaded file of requests.
+inline Json CategoryBatch::create(Json input) { return openai_.post("batches", input); }
+
+// GET https://api.openai.com/v1/batches/{batch_id}
+// Retrieves a batch.
+inline Json CategoryBatch::retrieve(const std::string &batch_id) { return openai_.get("batches/" + batch_id); }
+
+// POST https://api.openai.com/v1/batches/{batch_id}/cancel
+// Cancels an in-progress batch.
+inline Json CategoryBatch::cancel(const std::string &batch_id) {
+    return openai_.post("batches/" + batch_id + "/cancel", Json::object());
+}
+
+// GET https://api.openai.com/v1/batches
+// List your organization's batches.
+inline Json CategoryBatch::list() { return openai_.get("batches"); }
+
 } // namespace _detail
 
 // Public interface
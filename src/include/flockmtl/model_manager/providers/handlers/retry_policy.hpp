@@ -0,0 +1,123 @@
+#pragma once
+
+#include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <random>
+#include <string>
+
+namespace flockmtl {
+
+// Decides whether a failed request is worth sending again and how long to wait before doing so.
+struct RetryPolicy {
+    int32_t max_retries = 5;
+    int32_t base_delay_ms = 500;
+    int32_t max_delay_ms = 60000;
+
+    static bool IsRetryable(const CURLcode code) {
+        switch (code) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_HTTP2:
+        case CURLE_HTTP2_STREAM:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool IsRetryable(const long status_code, const std::string& body) {
+        if (status_code == 429) {
+            // An exhausted quota or billing limit will not recover by waiting
+            return body.find("insufficient_quota") == std::string::npos;
+        }
+        return status_code == 408 || status_code == 409 || status_code == 425 ||
+               (status_code >= 500 && status_code != 501 && status_code != 505);
+    }
+
+    // Full jitter exponential backoff, never shorter than what the server asked us to wait.
+    std::chrono::milliseconds GetDelay(const int32_t attempt, const long status_code,
+                                       const std::map<std::string, std::string>& headers) const {
+        static thread_local std::mt19937 generator {std::random_device {}()};
+        const auto cap = std::min<double>(max_delay_ms, base_delay_ms * std::pow(2.0, attempt));
+        std::uniform_real_distribution<double> distribution(0, cap);
+        const auto backoff = static_cast<int64_t>(distribution(generator));
+        const auto requested = std::min<int64_t>(GetServerDelay(headers, status_code == 429), max_delay_ms);
+        return std::chrono::milliseconds(std::max(backoff, requested));
+    }
+
+    // Parses `Retry-After` (seconds or HTTP-date) and, for rate limited responses, `x-ratelimit-reset-*`
+    // (e.g. "1s", "6m0s", "20ms").
+    static int64_t GetServerDelay(const std::map<std::string, std::string>& headers, const bool rate_limited) {
+        int64_t delay_ms = 0;
+        if (const auto it = headers.find("retry-after-ms"); it != headers.end()) {
+            delay_ms = std::max<int64_t>(delay_ms, std::atoll(it->second.c_str()));
+        }
+        if (const auto it = headers.find("retry-after"); it != headers.end()) {
+            delay_ms = std::max(delay_ms, ParseRetryAfter(it->second));
+        }
+        for (const std::string kind : {"requests", "tokens"}) {
+            // Only the budget that is actually exhausted is worth waiting for
+            const auto remaining = headers.find("x-ratelimit-remaining-" + kind);
+            const auto reset = headers.find("x-ratelimit-reset-" + kind);
+            if (rate_limited && reset != headers.end() &&
+                (remaining == headers.end() || std::atoll(remaining->second.c_str()) <= 0)) {
+                delay_ms = std::max(delay_ms, ParseDuration(reset->second));
+            }
+        }
+        return delay_ms;
+    }
+
+    static int64_t ParseRetryAfter(const std::string& value) {
+        if (!value.empty() && std::all_of(value.begin(), value.end(), ::isdigit)) {
+            return std::atoll(value.c_str()) * 1000;
+        }
+        const auto date = curl_getdate(value.c_str(), nullptr);
+        if (date < 0) {
+            return 0;
+        }
+        return std::max<int64_t>(0, (static_cast<int64_t>(date) - std::time(nullptr)) * 1000);
+    }
+
+    static int64_t ParseDuration(const std::string& value) {
+        double total_ms = 0;
+        size_t pos = 0;
+        while (pos < value.size()) {
+            size_t consumed = 0;
+            double amount;
+            try {
+                amount = std::stod(value.substr(pos), &consumed);
+            } catch (const std::exception&) {
+                return static_cast<int64_t>(total_ms);
+            }
+            pos += consumed;
+            if (value.compare(pos, 2, "ms") == 0) {
+                total_ms += amount;
+                pos += 2;
+            } else if (value.compare(pos, 1, "h") == 0) {
+                total_ms += amount * 3600000;
+                pos += 1;
+            } else if (value.compare(pos, 1, "m") == 0) {
+                total_ms += amount * 60000;
+                pos += 1;
+            } else {
+                total_ms += amount * 1000;
+                pos += value.compare(pos, 1, "s") == 0 ? 1 : 0;
+            }
+        }
+        return static_cast<int64_t>(std::ceil(total_ms));
+    }
+};
+
+} // namespace flockmtl
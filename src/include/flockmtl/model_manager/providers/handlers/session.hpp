@@ -1,16 +1,27 @@
 #pragma once
 
 #include <curl/curl.h>
+#include <algorithm>
+#include <exception>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <stdexcept>
 #include <iostream>
 #include <map>
+#include <thread>
+
+#include "retry_policy.hpp"
+#include "flockmtl/model_manager/rate_limiter.hpp"
+#include "flockmtl/model_manager/request_scheduler.hpp"
 
 struct Response {
     std::string text;
     bool is_error;
     std::string error_message;
+    long status_code = 0;
+    // Response headers with lower-cased names
+    std::map<std::string, std::string> headers;
 };
 
 // Simple curl Session inspired by CPR
@@ -31,19 +42,22 @@ public:
 
     ~Session() {
         curl_easy_cleanup(curl_);
-        curl_global_cleanup();
         if (mime_form_ != nullptr) {
             curl_mime_free(mime_form_);
         }
     }
 
     void initCurl() {
-        curl_global_init(CURL_GLOBAL_ALL);
+        // Sessions may be created from several threads at once, and curl's global state is not thread safe
+        static std::once_flag curl_global_init_flag;
+        std::call_once(curl_global_init_flag, []() { curl_global_init(CURL_GLOBAL_ALL); });
         curl_ = curl_easy_init();
         if (curl_ == nullptr) {
             throw std::runtime_error("curl cannot initialize"); // here we throw it shouldn't happen
         }
         curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1);
+        // An empty string lets curl advertise and transparently decode every compression it was built with
+        curl_easy_setopt(curl_, CURLOPT_ACCEPT_ENCODING, "");
     }
 
     void ignoreSSL() { curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L); }
@@ -61,6 +75,19 @@ public:
 
     void setBeta(const std::string &beta) { beta_ = beta; }
 
+    void setRetryPolicy(const flockmtl::RetryPolicy &retry_policy) { retry_policy_ = retry_policy; }
+
+    void setRateLimiter(std::shared_ptr<flockmtl::RateLimiter> rate_limiter, int64_t request_cost) {
+        rate_limiter_ = std::move(rate_limiter);
+        request_cost_ = request_cost;
+    }
+
+    // Hands the body of successful responses to `consumer` as it arrives instead of collecting it in the response
+    // text. An exception thrown by the consumer aborts the transfer and is rethrown to the caller.
+    void setStreamConsumer(std::function<void(const char *, size_t)> consumer) {
+        stream_consumer_ = std::move(consumer);
+    }
+
     void setBody(const std::string &data);
     void setMultiformPart(const std::pair<std::string, std::string> &filefield_and_filepath,
                           const std::map<std::string, std::string> &fields);
@@ -75,11 +102,56 @@ public:
     Response validOllamaModelsJson(const std::string &url);
 
 private:
+    Response performWithRetry(const std::string &error_prefix);
+
     static size_t writeFunction(void *ptr, size_t size, size_t nmemb, std::string *data) {
         data->append((char *)ptr, size * nmemb);
         return size * nmemb;
     }
 
+    struct StreamContext {
+        CURL *curl;
+        const std::function<void(const char *, size_t)> *consumer;
+        // Body of error responses, which are plain JSON documents rather than streams
+        std::string *error_body;
+        // Whether part of the body was already consumed, after which the request cannot be retried
+        bool consumed = false;
+        std::exception_ptr error;
+    };
+
+    static size_t streamWriteFunction(void *ptr, size_t size, size_t nmemb, StreamContext *stream) {
+        long status_code = 0;
+        curl_easy_getinfo(stream->curl, CURLINFO_RESPONSE_CODE, &status_code);
+        if (status_code >= 400) {
+            stream->error_body->append((char *)ptr, size * nmemb);
+            return size * nmemb;
+        }
+        // Exceptions cannot cross curl, returning a short count makes it abort the transfer instead
+        try {
+            stream->consumed = true;
+            (*stream->consumer)((char *)ptr, size * nmemb);
+        } catch (...) {
+            stream->error = std::current_exception();
+            return 0;
+        }
+        return size * nmemb;
+    }
+
+    static size_t headerFunction(char *buffer, size_t size, size_t nitems, std::map<std::string, std::string> *headers) {
+        const std::string line(buffer, size * nitems);
+        const auto separator = line.find(':');
+        if (separator != std::string::npos) {
+            auto name = line.substr(0, separator);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            const auto value_begin = line.find_first_not_of(" \t", separator + 1);
+            const auto value_end = line.find_last_not_of(" \t\r\n");
+            (*headers)[name] = value_begin == std::string::npos || value_end < value_begin
+                                   ? ""
+                                   : line.substr(value_begin, value_end - value_begin + 1);
+        }
+        return size * nitems;
+    }
+
 private:
     CURL *curl_;
     CURLcode res_;
@@ -92,6 +164,10 @@ private:
     std::string provider_;
 
     bool throw_exception_;
+    flockmtl::RetryPolicy retry_policy_;
+    std::shared_ptr<flockmtl::RateLimiter> rate_limiter_;
+    int64_t request_cost_ = 0;
+    std::function<void(const char *, size_t)> stream_consumer_;
     std::mutex mutex_request_;
 };
 
@@ -102,25 +178,7 @@ inline Response Session::validOllamaModelsJson(const std::string &url) {
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
 
-    std::string response_string;
-    std::string header_string;
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
-    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &header_string);
-
-    res_ = curl_easy_perform(curl_);
-    bool is_error = false;
-    std::string error_msg {};
-    if (res_ != CURLE_OK) {
-        is_error = true;
-        error_msg = " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
-        if (throw_exception_) {
-            throw std::runtime_error(error_msg);
-        } else {
-            std::cerr << error_msg << '\n';
-        }
-    }
-    return {response_string, is_error, error_msg};
+    return performWithRetry("");
 }
 
 inline void Session::setBody(const std::string &data) {
@@ -174,26 +232,7 @@ inline Response Session::postPrepareOllama(const std::string &contentType) {
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
 
-    std::string response_string;
-    std::string header_string;
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
-    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &header_string);
-
-    res_ = curl_easy_perform(curl_);
-
-    bool is_error = false;
-    std::string error_msg {};
-    if (res_ != CURLE_OK) {
-        is_error = true;
-        error_msg = provider_ + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
-        if (throw_exception_) {
-            throw std::runtime_error(error_msg);
-        } else {
-            std::cerr << error_msg << '\n';
-        }
-    }
-    return {response_string, is_error, error_msg};
+    return performWithRetry(provider_);
 }
 
 inline Response Session::deletePrepare() {
@@ -247,19 +286,78 @@ inline Response Session::makeRequest(const std::string &contentType) {
     curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl_, CURLOPT_URL, url_.c_str());
 
+    return performWithRetry(provider_);
+}
+
+inline Response Session::performWithRetry(const std::string &error_prefix) {
     std::string response_string;
-    std::string header_string;
-    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
-    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
-    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &header_string);
+    std::map<std::string, std::string> response_headers;
+    long status_code = 0;
+    StreamContext stream {curl_, &stream_consumer_, &response_string};
+    if (stream_consumer_) {
+        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, streamWriteFunction);
+        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &stream);
+    } else {
+        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFunction);
+        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_string);
+    }
+    curl_easy_setopt(curl_, CURLOPT_HEADERFUNCTION, headerFunction);
+    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &response_headers);
+
+    for (int32_t attempt = 0;; attempt++) {
+        response_string.clear();
+        response_headers.clear();
+        status_code = 0;
+
+        if (rate_limiter_) {
+            rate_limiter_->Acquire(request_cost_);
+        }
+        // The scheduler slot is only held while the request is in flight, and given back before any backoff
+        auto slot = flockmtl::RequestScheduler::AcquireForAttempt();
+        res_ = curl_easy_perform(curl_);
+        slot.reset();
+        if (res_ == CURLE_OK) {
+            curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status_code);
+            if (rate_limiter_) {
+                rate_limiter_->Calibrate(response_headers);
+            }
+        }
+
+        if (stream.error) {
+            std::rethrow_exception(stream.error);
+        }
+        const auto retryable = res_ != CURLE_OK ? flockmtl::RetryPolicy::IsRetryable(res_)
+                                                : flockmtl::RetryPolicy::IsRetryable(status_code, response_string);
+        // A stream that was partly consumed cannot be replayed
+        if (!retryable || stream.consumed || attempt >= retry_policy_.max_retries) {
+            break;
+        }
+        std::this_thread::sleep_for(retry_policy_.GetDelay(attempt, status_code, response_headers));
+    }
 
-    res_ = curl_easy_perform(curl_);
+    // An endpoint still failing after the retries is set aside for a while, whatever its quota says
+    const auto unavailable =
+        res_ != CURLE_OK ? flockmtl::RetryPolicy::IsRetryable(res_)
+                         : status_code == 429 || flockmtl::RetryPolicy::IsRetryable(status_code, response_string);
+    const auto ejected = rate_limiter_ && unavailable;
+    if (ejected) {
+        rate_limiter_->Eject();
+    }
 
     bool is_error = false;
     std::string error_msg {};
     if (res_ != CURLE_OK) {
         is_error = true;
-        error_msg = provider_ + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
+        error_msg = error_prefix + " curl_easy_perform() failed: " + std::string {curl_easy_strerror(res_)};
+    } else if (status_code >= 400) {
+        is_error = true;
+        error_msg = error_prefix + " request failed with HTTP status " + std::to_string(status_code) + ": " +
+                    response_string;
+    }
+    if (throw_exception_ && ejected) {
+        throw flockmtl::EndpointUnavailableError(error_msg);
+    }
+    if (res_ != CURLE_OK) {
         if (throw_exception_) {
             throw std::runtime_error(error_msg);
         } else {
@@ -267,7 +365,7 @@ inline Response Session::makeRequest(const std::string &contentType) {
         }
     }
 
-    return {response_string, is_error, error_msg};
+    return {response_string, is_error, error_msg, status_code, response_headers};
 }
 
 inline std::string Session::easyEscape(const std::string &text) {
@@ -4,24 +4,99 @@
 #include "fmt/format.h"
 
 #include "flockmtl/model_manager/repository.hpp"
+#include "flockmtl/model_manager/embedding_batcher.hpp"
+#include "flockmtl/model_manager/completion_stream.hpp"
 
 namespace flockmtl {
 
+struct TokenUsage {
+    int32_t prompt_tokens = 0;
+    int32_t completion_tokens = 0;
+};
+
+class ExceededMaxOutputTokensError : public std::exception {
+public:
+    const char* what() const noexcept override {
+        return "The response exceeded the max_output_tokens length; increase your max_output_tokens parameter.";
+    }
+};
+
 class IProvider {
 public:
     ModelDetails model_details_;
+    // Token usage reported for the last completion call made by this thread; kept per thread since the same provider
+    // serves concurrent calls
+    inline static thread_local TokenUsage last_usage_;
 
     explicit IProvider(const ModelDetails& model_details) : model_details_(model_details) {};
     virtual ~IProvider() = default;
 
     virtual nlohmann::json CallComplete(const std::string& prompt, bool json_response) = 0;
-    virtual nlohmann::json CallEmbedding(const std::vector<std::string>& inputs) = 0;
-};
+    virtual std::vector<std::vector<float>> CallEmbedding(const std::vector<std::string>& inputs) = 0;
+    // Streams the completion of a tuple prompt, handing every tuple of its `{"tuples": [...]}` response to
+    // `on_tuple` as soon as it is generated. Providers without a streaming endpoint complete the prompt at once.
+    virtual void CallCompleteStream(const std::string& prompt, const std::function<void(nlohmann::json)>& on_tuple) {
+        for (auto& tuple : CallComplete(prompt, true)["tuples"]) {
+            on_tuple(std::move(tuple));
+        }
+    }
+    // Per request limits of the embedding endpoint, used to split the inputs of a chunk into sub-batches
+    virtual EmbeddingBatchLimits GetEmbeddingBatchLimits() const = 0;
 
-class ExceededMaxOutputTokensError : public std::exception {
-public:
-    const char* what() const noexcept override {
-        return "The response exceeded the max_output_tokens length; increase your max_output_tokens parameter.";
+    // Offline batch execution, only implemented by providers exposing a batch endpoint
+    virtual nlohmann::json GetCompletionPayload(const std::string& prompt, bool json_response) {
+        throw OfflineExecutionNotSupported();
+    }
+    virtual nlohmann::json ParseCompletion(const nlohmann::json& completion, bool json_response) {
+        throw OfflineExecutionNotSupported();
+    }
+    virtual std::string SubmitBatch(const std::string& requests_file_path, const std::string& endpoint) {
+        throw OfflineExecutionNotSupported();
+    }
+    virtual nlohmann::json RetrieveBatch(const std::string& batch_id) { throw OfflineExecutionNotSupported(); }
+    virtual std::string DownloadFile(const std::string& file_id) { throw OfflineExecutionNotSupported(); }
+
+protected:
+    // Records the usage of a completion and checks how it ended, throwing when its content is incomplete or refused
+    void CheckCompletion(const CompletionResponse& response, const std::string& safety_system) {
+        last_usage_.prompt_tokens = response.prompt_tokens;
+        last_usage_.completion_tokens = response.completion_tokens;
+
+        // Check if the conversation was too long for the context window
+        if (response.finish_reason == "length") {
+            throw ExceededMaxOutputTokensError();
+        }
+        // Check if the safety system refused the request
+        if (!response.refusal.empty()) {
+            throw std::runtime_error(duckdb_fmt::format(
+                "The request was refused due to {}'s safety system.{{\"refusal\": \"{}\"}}", safety_system,
+                response.refusal));
+        }
+        // Check if the model's output included restricted content
+        if (response.finish_reason == "content_filter") {
+            throw std::runtime_error("The content filter was triggered, resulting in incomplete JSON.");
+        }
+    }
+
+    nlohmann::json FinishCompletion(CompletionResponse& response, const bool json_response,
+                                    const std::string& safety_system) {
+        CheckCompletion(response, safety_system);
+        if (json_response) {
+            return nlohmann::json::parse(response.content);
+        }
+        return std::move(response.content);
+    }
+
+    // Checks how a streamed completion ended, as FinishCompletion checks a complete response
+    void FinishCompletionStream(CompletionStream& stream, const std::string& safety_system) {
+        CheckCompletion(stream.Finish(), safety_system);
+        stream.CheckComplete();
+    }
+
+private:
+    std::runtime_error OfflineExecutionNotSupported() const {
+        return std::runtime_error(duckdb_fmt::format("Offline execution is not supported by the `{}` provider",
+                                                     model_details_.provider_name));
     }
 };
 
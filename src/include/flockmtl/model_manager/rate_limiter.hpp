@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "flockmtl/model_manager/repository.hpp"
+
+namespace flockmtl {
+
+// Thrown by the request that got its endpoint ejected, so that pooled models send it to another endpoint
+class EndpointUnavailableError : public std::runtime_error {
+public:
+    explicit EndpointUnavailableError(const std::string& message) : std::runtime_error(message) {}
+};
+
+// Client side token bucket limiter enforcing requests-per-minute and tokens-per-minute budgets.
+// One limiter is shared by every request sent to the same provider, model and endpoint in the process.
+class RateLimiter {
+public:
+    RateLimiter(int32_t requests_per_minute, int32_t tokens_per_minute);
+
+    static std::shared_ptr<RateLimiter> Get(const ModelDetails& model_details);
+    // Identifies the provider, model and endpoint a request is sent to
+    static std::string GetKey(const ModelDetails& model_details);
+
+    // Applies the user limits of the model, 0 leaving the budget to be learned from the provider's headers
+    void SetLimits(int32_t requests_per_minute, int32_t tokens_per_minute);
+
+    // Reserves one request and `tokens` tokens, waiting until both budgets allow it.
+    void Acquire(int64_t tokens);
+    // Adjusts the budgets to the `x-ratelimit-*` headers returned by the provider.
+    void Calibrate(const std::map<std::string, std::string>& headers);
+    // Fraction of the tighter budget still available, 1 when no budget is known.
+    double GetHeadroom();
+    // Marks the endpoint as unavailable for `ejection_ms`, so that pooled models route around it meanwhile.
+    void Eject();
+    bool IsEjected();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+        double capacity = 0;
+        double available = 0;
+        // Whether the limit was set by the user, in which case the headers cannot raise it
+        bool configured = false;
+
+        bool IsEnabled() const { return capacity > 0; }
+        void SetLimit(double limit);
+        // Applies a user limit, unless it is already in place
+        void Configure(int32_t limit);
+        void Refill(double elapsed_ms);
+        // Takes `amount` out of the bucket and returns how long the caller has to wait for it
+        double Reserve(double amount);
+    };
+
+    // Learned limits are scaled down slightly so requests are paced just under the provider's limit
+    constexpr static double learned_limit_ratio = 0.95;
+    constexpr static int64_t ejection_ms = 30000;
+
+    std::mutex mutex_;
+    Bucket requests_;
+    Bucket tokens_;
+    Clock::time_point last_refill_;
+    Clock::time_point ejected_until_;
+
+    void Refill();
+
+    static std::mutex registry_mutex_;
+    static std::map<std::string, std::shared_ptr<RateLimiter>> registry_;
+};
+
+} // namespace flockmtl
@@ -3,6 +3,8 @@
 #include <string>
 #include <algorithm>
 
+#include "flockmtl/model_manager/providers/handlers/retry_policy.hpp"
+
 namespace flockmtl {
 
 struct ModelDetails {
@@ -12,7 +14,23 @@ struct ModelDetails {
     int32_t context_window;
     int32_t max_output_tokens;
     float temperature;
+    // Name of the secret the requests are sent with, one of the pool of the model
+    std::string secret_name;
     std::unordered_map<std::string, std::string> secret;
+    RetryPolicy retry_policy;
+    int32_t requests_per_minute;
+    int32_t tokens_per_minute;
+    // Requests to the model allowed in flight at once across the process, 0 when only the global limit applies
+    int32_t max_concurrent_requests;
+    // Whether requests go through the provider's offline batch endpoint instead of being sent one by one
+    bool offline_execution;
+    int32_t batch_poll_interval_seconds;
+    // Whether online completions of tuple prompts are streamed, so that tuples are parsed as they are generated
+    bool stream;
+    // Size of the embeddings returned by the model, 0 when unknown
+    int32_t dimensions;
+    // Whether `dimensions` shortens the embeddings of a text-embedding-3 model, and is then sent to the provider
+    bool reduced_dimensions;
 };
 
 const std::string OLLAMA = "ollama";
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/model_manager/repository.hpp"
+
+namespace flockmtl {
+
+// Scheduling class of the requests of a connection, set with `SET flockmtl_request_priority`
+enum class RequestPriority { INTERACTIVE = 0, NORMAL, BATCH };
+
+// Query a request is sent for, the unit the scheduler shares the slots between
+struct RequestOrigin {
+    // 0 when the request was not sent from a known query
+    uint64_t query_id = 0;
+    RequestPriority priority = RequestPriority::NORMAL;
+};
+
+// Process-wide owner of the outbound LLM requests. Every attempt of an online request takes a slot while it is in
+// flight, bounded by a global limit (`SET GLOBAL flockmtl_max_concurrent_requests`) and by the
+// `max_concurrent_requests` of its model.
+// Free slots go to the highest priority class with waiting requests, and within a class to the query that has been
+// granted the fewest, so that a large backfill cannot starve the interactive queries running next to it.
+class RequestScheduler {
+public:
+    // Held while a request is in flight, releases its slot when destroyed
+    class Slot {
+    public:
+        Slot(RequestScheduler* scheduler, std::string model_key, uint64_t query_id)
+            : scheduler_(scheduler), model_key_(std::move(model_key)), query_id_(query_id) {}
+        Slot(Slot&& other) noexcept
+            : scheduler_(other.scheduler_), model_key_(std::move(other.model_key_)), query_id_(other.query_id_) {
+            other.scheduler_ = nullptr;
+        }
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot& operator=(Slot&&) = delete;
+        ~Slot();
+
+    private:
+        RequestScheduler* scheduler_;
+        std::string model_key_;
+        uint64_t query_id_;
+    };
+
+    // Sets the origin of the requests of the models created on this thread while it is alive
+    class OriginScope {
+    public:
+        // Reads the priority from the settings of the connection
+        explicit OriginScope(duckdb::ClientContext& context);
+        ~OriginScope();
+
+        OriginScope(const OriginScope&) = delete;
+        OriginScope& operator=(const OriginScope&) = delete;
+
+    private:
+        RequestOrigin previous_;
+    };
+
+    // Schedules the requests sent by this thread while it is alive. The slot is taken by the HTTP session for every
+    // attempt, once the rate limiter let it through, so that no slot is held while waiting for quota or a retry.
+    class Admission {
+    public:
+        Admission(const ModelDetails& model_details, const RequestOrigin& origin);
+        ~Admission();
+
+        Admission(const Admission&) = delete;
+        Admission& operator=(const Admission&) = delete;
+
+    private:
+        friend class RequestScheduler;
+        const ModelDetails& model_details_;
+        RequestOrigin origin_;
+        Admission* previous_;
+    };
+
+    static RequestScheduler& Get();
+    static RequestOrigin GetCurrentOrigin();
+    // Origin of the requests sent for the active query of the connection, with its priority setting
+    static RequestOrigin GetOrigin(duckdb::ClientContext& context);
+    // Waits for a slot for one attempt of a request sent under the Admission of this thread; requests sent without
+    // one, such as the calls of offline batch jobs, are not scheduled
+    static std::optional<Slot> AcquireForAttempt();
+    // Registers the settings of the scheduler with the database
+    static void RegisterSettings(duckdb::DatabaseInstance& db);
+
+    // Waits until the request can be sent under the global limit and the `max_concurrent_requests` of the model
+    Slot Acquire(const ModelDetails& model_details, const RequestOrigin& origin);
+    // 0 lifts the limit
+    void SetGlobalLimit(size_t limit);
+
+    constexpr static int64_t default_max_concurrent_requests = 64;
+
+private:
+    struct Waiter {
+        RequestOrigin origin;
+        std::string model_key;
+        size_t model_limit;
+        uint64_t sequence;
+        bool granted = false;
+    };
+    struct QueryState {
+        // Requests granted so far, in the virtual time of its class
+        uint64_t virtual_time = 0;
+        // Requests waiting or in flight; the state is dropped once there are none
+        size_t active = 0;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable granted_;
+    size_t global_limit_ = default_max_concurrent_requests;
+    size_t in_flight_ = 0;
+    std::map<std::string, size_t> model_in_flight_;
+    std::map<uint64_t, QueryState> queries_;
+    // Virtual time of the last grant of each class, where the queries joining the class start
+    uint64_t class_time_[3] = {0, 0, 0};
+    std::list<Waiter*> waiters_;
+    uint64_t next_sequence_ = 0;
+
+    // Grants the free slots to the waiting requests; called with the mutex held
+    void Dispatch();
+    void Release(const std::string& model_key, uint64_t query_id);
+};
+
+} // namespace flockmtl
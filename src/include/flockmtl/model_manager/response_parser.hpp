@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace flockmtl {
+
+// Fields of a completion response that the providers check and return
+struct CompletionResponse {
+    std::string content;
+    std::string finish_reason;
+    // Explanation of the safety system when it refused the request
+    std::string refusal;
+    int32_t prompt_tokens = 0;
+    int32_t completion_tokens = 0;
+};
+
+// Reads a provider response in a single SAX pass over the body, keeping only the fields it needs instead of
+// materializing the whole document. Subclasses pick the values they want by their path from the root.
+class ResponseParser : public nlohmann::json_sax<nlohmann::json> {
+public:
+    // Returns false when the body is not valid JSON
+    bool Parse(const std::string& body);
+    // Whether the root object has an `error` member; the rare failed response is parsed again to report it
+    bool HasError() const { return has_error_; }
+
+    bool null() final;
+    bool boolean(bool value) final;
+    bool number_integer(number_integer_t value) final;
+    bool number_unsigned(number_unsigned_t value) final;
+    bool number_float(number_float_t value, const string_t&) final;
+    bool string(string_t& value) final;
+    bool binary(binary_t&) final;
+    bool start_object(std::size_t) final;
+    bool key(string_t& value) final;
+    bool end_object() final;
+    bool start_array(std::size_t) final;
+    bool end_array() final;
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) final;
+
+protected:
+    // Number of containers enclosing the current value, 1 for the members of the root object
+    size_t Depth() const { return path_.size(); }
+    // Key of the current member of the object at `level`, or empty when it is an array
+    const std::string& KeyAt(size_t level) const { return path_[level].key; }
+    // Position of the current element of the array at `level`
+    size_t IndexAt(size_t level) const { return path_[level].index; }
+
+    // Values are handed over with the path of the current value; strings may be moved from
+    virtual void OnString(std::string& value) {}
+    virtual void OnNumber(double value) {}
+    virtual void OnBoolean(bool value) {}
+    // Called when an array starts and after it ends, with the path of the array itself
+    virtual void OnStartArray() {}
+    virtual void OnEndArray() {}
+
+private:
+    struct Level {
+        bool is_array;
+        size_t index;
+        std::string key;
+    };
+    std::vector<Level> path_;
+    bool has_error_ = false;
+
+    void EndValue();
+};
+
+// `{"choices": [{"message": {"content", "refusal"}, "finish_reason"}], "usage": {...}}` of the chat completions
+// endpoints of OpenAI and Azure
+class ChatCompletionParser : public ResponseParser {
+public:
+    CompletionResponse response;
+
+protected:
+    void OnString(std::string& value) override;
+    void OnNumber(double value) override;
+
+private:
+    bool InFirstChoice() const { return Depth() >= 3 && KeyAt(0) == "choices" && IndexAt(1) == 0; }
+};
+
+// `{"response", "done", "done_reason", "prompt_eval_count", "eval_count"}` of the Ollama generate endpoint
+class OllamaCompletionParser : public ResponseParser {
+public:
+    CompletionResponse response;
+    bool done = true;
+
+protected:
+    void OnString(std::string& value) override;
+    void OnNumber(double value) override;
+    void OnBoolean(bool value) override;
+};
+
+// Embeddings of `{"data": [{"embedding"}]}` (OpenAI and Azure), as base64 strings or arrays of numbers, and of
+// `{"embeddings": [[...]]}` (Ollama). The numbers are appended to the output as they are read.
+class EmbeddingParser : public ResponseParser {
+public:
+    std::vector<std::vector<float>> embeddings;
+
+protected:
+    void OnString(std::string& value) override;
+    void OnNumber(double value) override;
+    void OnStartArray() override;
+    void OnEndArray() override;
+
+private:
+    bool AtEmbedding() const;
+    // Embedding being read, while inside its array of numbers
+    std::vector<float>* current_ = nullptr;
+};
+
+} // namespace flockmtl
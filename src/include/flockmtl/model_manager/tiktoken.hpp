@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string_view>
+
 #include "flockmtl/core/common.hpp"
 
 namespace flockmtl {
@@ -7,6 +9,12 @@ namespace flockmtl {
 class Tiktoken {
 public:
     static int GetNumTokens(const std::string& str);
+    static int GetNumTokens(const std::vector<std::string>& strs);
+
+    // Finds the first token starting at or after `offset`, as the byte range [begin, end) of `str`. Returns false
+    // when only whitespace is left. Tokens are words, single punctuation characters or single non-ASCII characters,
+    // so a range never splits a UTF-8 character.
+    static bool NextToken(std::string_view str, size_t offset, size_t& begin, size_t& end);
 };
 
 } // namespace flockmtl
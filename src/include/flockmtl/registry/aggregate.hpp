@@ -13,6 +13,8 @@ private:
     static void RegisterLlmLast(duckdb::DatabaseInstance& db);
     static void RegisterLlmRerank(duckdb::DatabaseInstance& db);
     static void RegisterLlmReduce(duckdb::DatabaseInstance& db);
+    static void RegisterFusionStats(duckdb::DatabaseInstance& db);
+    static void RegisterVectorAggregates(duckdb::DatabaseInstance& db);
 };
 
 } // namespace flockmtl
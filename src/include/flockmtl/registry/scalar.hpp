@@ -13,7 +13,9 @@ private:
     static void RegisterLlmComplete(duckdb::DatabaseInstance& db);
     static void RegisterLlmEmbedding(duckdb::DatabaseInstance& db);
     static void RegisterLlmFilter(duckdb::DatabaseInstance& db);
-    static void RegisterFusionRelative(duckdb::DatabaseInstance& db);
+    static void RegisterFusion(duckdb::DatabaseInstance& db);
+    static void RegisterVectorSimilarity(duckdb::DatabaseInstance& db);
+    static void RegisterVectorQuantization(duckdb::DatabaseInstance& db);
 };
 
 } // namespace flockmtl
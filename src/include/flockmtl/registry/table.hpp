@@ -0,0 +1,22 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+class TableRegistry {
+public:
+    static void Register(duckdb::DatabaseInstance& db);
+
+private:
+    static void RegisterChunkText(duckdb::DatabaseInstance& db);
+    static void RegisterHybridSearch(duckdb::DatabaseInstance& db);
+    static void RegisterLlmMap(duckdb::DatabaseInstance& db);
+    static void RegisterVectorIndex(duckdb::DatabaseInstance& db);
+    static void RegisterVectorKMeans(duckdb::DatabaseInstance& db);
+    static void RegisterVectorSearchExact(duckdb::DatabaseInstance& db);
+    static void RegisterVectorSearchRescore(duckdb::DatabaseInstance& db);
+    static void RegisterVectorSimilarityJoin(duckdb::DatabaseInstance& db);
+};
+
+} // namespace flockmtl
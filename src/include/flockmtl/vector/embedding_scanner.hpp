@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+// Column of a table holding embeddings, with an integer key identifying each row
+struct EmbeddingSource {
+    std::string table_name;
+    std::string key_column;
+    std::string embedding_column;
+    // Optional SQL condition restricting the rows
+    std::string filter;
+
+    // The names quoted for a query; a qualified table name is quoted part by part
+    std::string GetQuotedTable() const;
+    std::string GetQuotedKey() const;
+    std::string GetQuotedEmbedding() const;
+};
+
+// Rows of an embedding column copied into contiguous memory
+struct EmbeddingBlock {
+    std::vector<int64_t> keys;
+    std::vector<float> vectors;
+    size_t dimensions = 0;
+
+    size_t Size() const { return keys.size(); }
+    const float* GetVector(const size_t row) const { return vectors.data() + row * dimensions; }
+};
+
+// Streams the rows of an embedding column with a non NULL key and embedding, chunk by chunk, so the table is never
+// materialized in memory. Every embedding must have the same number of dimensions.
+// The table is read through its own connection to the database the extension was loaded in last, so it only sees
+// committed rows of persistent tables: TEMP tables and the uncommitted changes of the calling transaction are not.
+class EmbeddingScanner {
+public:
+    EmbeddingScanner(duckdb::Connection& con, const EmbeddingSource& source);
+
+    // Replaces the content of the block with the next rows, at least `min_rows` unless the scan ends.
+    // Returns false once every row was read.
+    bool Next(EmbeddingBlock& block, size_t min_rows = STANDARD_VECTOR_SIZE);
+    // Reads every remaining row into a single block
+    EmbeddingBlock ReadAll();
+    // Reads the remaining rows in blocks of `block_rows` on the calling thread while `num_threads` workers process
+    // them; `process(worker, block)` is called concurrently for different workers. The first error is rethrown.
+    void ScanParallel(size_t num_threads, size_t block_rows,
+                      const std::function<void(size_t, EmbeddingBlock&)>& process);
+    // Dimensions of the embeddings, 0 until the first row is read
+    size_t GetDimensions() const { return dimensions_; }
+
+private:
+    std::string embedding_column_;
+    duckdb::unique_ptr<duckdb::QueryResult> result_;
+    size_t dimensions_ = 0;
+};
+
+} // namespace flockmtl
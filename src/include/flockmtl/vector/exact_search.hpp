@@ -0,0 +1,40 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "flockmtl/vector/embedding_scanner.hpp"
+#include "flockmtl/vector/metric.hpp"
+
+namespace flockmtl {
+
+// Brute force k nearest neighbor search of a batch of queries over an embedding column. Blocks of rows are scored
+// in parallel against every query while they are hot in cache, each thread keeping its own bounded heaps that are
+// merged once the scan ends.
+class ExactSearch {
+public:
+    using Result = std::vector<std::pair<int64_t, float>>;
+
+    ExactSearch(VectorMetric metric, std::vector<std::vector<float>> queries, size_t k);
+
+    // Returns the `k` nearest rows of every query, closest first, with the same distances as `VectorMetricUtil`
+    std::vector<Result> Run(EmbeddingScanner& scanner, size_t num_threads);
+
+    // Rows handed to a worker at once
+    constexpr static size_t block_rows = 8 * STANDARD_VECTOR_SIZE;
+    // Rows scored against every query before moving on, sized to stay in the L2 cache for large embeddings
+    constexpr static size_t tile_rows = 32;
+
+private:
+    using Heap = std::vector<std::pair<float, int64_t>>;
+
+    VectorMetric metric_;
+    std::vector<std::vector<float>> queries_;
+    std::vector<float> query_norms_;
+    size_t k_;
+
+    void ScoreBlock(const EmbeddingBlock& block, std::vector<Heap>& heaps) const;
+    static void Push(Heap& heap, size_t k, float distance, int64_t key);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "flockmtl/core/common.hpp"
+
+namespace flockmtl {
+
+// Read access to the rows of a T[N] or T[] vector without going through duckdb::Value.
+template <class T>
+class VectorReader {
+public:
+    VectorReader(duckdb::Vector& vector, duckdb::idx_t count);
+
+    // Constant vectors hold a single row shared by the whole chunk, e.g. a query embedding
+    bool IsConstant() const { return is_constant_; }
+    // Returns false when the row is NULL or contains NULL elements
+    bool Get(duckdb::idx_t row, const T*& data, duckdb::idx_t& size) const;
+
+    // Type the vector arguments are cast to: T[N] for arrays, T[] for lists
+    static duckdb::LogicalType GetCastType(const duckdb::LogicalType& type, const std::string& function_name);
+
+private:
+    bool is_array_;
+    bool is_constant_;
+    duckdb::idx_t array_size_ = 0;
+    const duckdb::list_entry_t* list_entries_ = nullptr;
+    const T* child_data_;
+    const duckdb::ValidityMask* validity_;
+    const duckdb::ValidityMask* child_validity_;
+};
+
+using FloatVectorReader = VectorReader<float>;
+using Int8VectorReader = VectorReader<int8_t>;
+
+} // namespace flockmtl
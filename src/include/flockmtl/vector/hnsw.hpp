@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "flockmtl/vector/metric.hpp"
+
+namespace flockmtl {
+
+// Hierarchical navigable small world graph over float32 vectors, for approximate nearest neighbor search.
+// Nodes are appended first and linked in parallel afterwards, so an existing graph grows incrementally.
+class HnswIndex {
+public:
+    HnswIndex(size_t dimensions, VectorMetric metric, size_t m, size_t ef_construction);
+
+    size_t GetDimensions() const { return dimensions_; }
+    VectorMetric GetMetric() const { return metric_; }
+    size_t GetM() const { return m_; }
+    size_t GetEfConstruction() const { return ef_construction_; }
+    size_t Size() const { return keys_.size(); }
+
+    void Reserve(size_t size);
+    // Stores the vector of a new node; it is only reachable once Link has been called
+    uint32_t Append(int64_t key, const float* vector);
+    void SetVector(uint32_t node, const float* vector);
+    // Connects every node appended since the last call, using up to `num_threads` threads
+    void Link(size_t num_threads);
+    // Returns the keys of the `k` nearest nodes with their distance to the query, closest first
+    std::vector<std::pair<int64_t, float>> Search(const float* query, size_t k, size_t ef_search) const;
+
+    // Deleted nodes keep routing searches but are never returned
+    void MarkDeleted(uint32_t node);
+    bool IsDeleted(uint32_t node) const { return deleted_[node] != 0; }
+    size_t GetDeletedCount() const { return deleted_count_; }
+
+    // Graph access used to persist the index and restore it
+    int64_t GetKey(uint32_t node) const { return keys_[node]; }
+    // Normalized for the cosine metric
+    const float* GetVector(uint32_t node) const { return vectors_.data() + static_cast<size_t>(node) * dimensions_; }
+    const std::vector<std::vector<uint32_t>>& GetLinks(uint32_t node) const { return links_[node]; }
+    uint32_t GetEntryPoint() const { return entry_point_; }
+    int GetMaxLevel() const { return max_level_; }
+    void SetLinks(uint32_t node, std::vector<std::vector<uint32_t>> links) { links_[node] = std::move(links); }
+    // Opaque value persisted with every node, used to tell when the row behind it changed
+    uint64_t GetVersion(uint32_t node) const { return versions_[node]; }
+    void SetVersion(uint32_t node, uint64_t version) { versions_[node] = version; }
+    // Marks the appended nodes as linked once their links were restored with SetLinks
+    void Restore(uint32_t entry_point, int max_level);
+
+private:
+    using Candidate = std::pair<float, uint32_t>;
+
+    constexpr static size_t lock_stripes = 4096;
+
+    size_t dimensions_;
+    VectorMetric metric_;
+    size_t m_;
+    size_t ef_construction_;
+    double level_multiplier_;
+
+    // Cosine vectors are stored normalized, so the distance reduces to an inner product
+    std::vector<float> vectors_;
+    std::vector<int64_t> keys_;
+    // Neighbors of every node on each of its levels
+    std::vector<std::vector<std::vector<uint32_t>>> links_;
+    std::vector<uint8_t> deleted_;
+    std::vector<uint64_t> versions_;
+    // Kept alongside `deleted_`, since every search needs it
+    size_t deleted_count_ = 0;
+    size_t linked_count_ = 0;
+
+    std::mutex entry_mutex_;
+    uint32_t entry_point_ = 0;
+    int max_level_ = -1;
+    std::unique_ptr<std::mutex[]> node_locks_;
+
+    std::mutex& GetNodeLock(uint32_t node) const { return node_locks_[node % lock_stripes]; }
+    size_t GetMaxLinks(int level) const { return level == 0 ? 2 * m_ : m_; }
+
+    float Distance(const float* a, const float* b) const;
+    float ToOutputDistance(float distance) const;
+    int GetRandomLevel(uint32_t node) const;
+    std::vector<uint32_t> CopyLinks(uint32_t node, int level) const;
+    uint32_t SearchGreedy(const float* query, uint32_t entry_point, int from_level, int to_level) const;
+    // Returns up to `ef` nodes of `level` closest to the query, closest first
+    std::vector<Candidate> SearchLayer(const float* query, uint32_t entry_point, size_t ef, int level) const;
+    std::vector<uint32_t> SelectNeighbors(std::vector<Candidate> candidates, size_t max_links) const;
+    void Insert(uint32_t node);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "flockmtl/vector/exact_search.hpp"
+
+namespace flockmtl {
+
+enum class HybridFusion { RRF, COMBSUM, COMBMNZ };
+
+struct HybridSearchOptions {
+    HybridFusion fusion = HybridFusion::RRF;
+    VectorMetric metric = VectorMetric::COSINE;
+    size_t k = 10;
+    // Length of the lexical and vector candidate lists that are fused
+    size_t candidates = 100;
+};
+
+struct HybridMatch {
+    int64_t key;
+    double score;
+    // 1-based positions of the row in the candidate lists, 0 when it is missing from a list
+    int32_t lexical_rank;
+    int32_t vector_rank;
+};
+
+// Full-text and vector search of the same table, fused into a single ranking. Both searches only keep their best
+// candidates, the lexical one through a top-N query over the BM25 scores of DuckDB's full-text search index and the
+// vector one with the bounded heaps of ExactSearch, and they run concurrently.
+class HybridSearch {
+public:
+    HybridSearch(HybridSearchOptions options, std::string query_text, std::vector<float> query_embedding);
+
+    // Accepts 'rrf', 'combsum' and 'combmnz'
+    static HybridFusion FusionFromString(const std::string& fusion);
+
+    // Returns the best `k` rows, best first. The table needs a full-text search index created with
+    // `PRAGMA create_fts_index(table_name, key_column, text_column)`.
+    std::vector<HybridMatch> Run(const EmbeddingSource& source, const std::string& text_column,
+                                 size_t num_threads) const;
+
+private:
+    HybridSearchOptions options_;
+    std::string query_text_;
+    std::vector<float> query_embedding_;
+
+    // Returns the rows matching the query text with their BM25 score, best first
+    ExactSearch::Result SearchLexical(const EmbeddingSource& source, const std::string& text_column) const;
+    std::vector<HybridMatch> Fuse(const ExactSearch::Result& lexical, const ExactSearch::Result& vector) const;
+};
+
+} // namespace flockmtl
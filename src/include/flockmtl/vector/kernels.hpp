@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flockmtl {
+
+// Distance kernels over float32 and quantized vectors. The implementation is selected once, from the instruction
+// sets supported by the CPU at runtime: AVX-512 or AVX2 on x86-64, NEON on ARM64, and a portable loop otherwise.
+class VectorKernels {
+public:
+    static float InnerProduct(const float* a, const float* b, size_t size);
+    static float SquaredNorm(const float* a, size_t size);
+    static float L2SquaredDistance(const float* a, const float* b, size_t size);
+    static float L1Distance(const float* a, const float* b, size_t size);
+    // Inner products of `a` with each of the `rows` consecutive vectors of `b`, written to `out`
+    static void InnerProducts(const float* a, const float* b, size_t rows, size_t size, float* out);
+
+    // Kernels over quantized vectors: int8 inner product, and number of differing bits between `size` bytes
+    static int32_t Int8InnerProduct(const int8_t* a, const int8_t* b, size_t size);
+    static uint64_t HammingDistance(const uint8_t* a, const uint8_t* b, size_t size);
+
+    // Element-wise kernels updating `size` running values in place: sums of `a * scale` accumulated in double
+    // precision, sums of partial sums, and minimums or maximums of `a`
+    static void Accumulate(double* sums, const float* a, float scale, size_t size);
+    static void Add(double* sums, const double* a, size_t size);
+    static void Minimum(float* values, const float* a, size_t size);
+    static void Maximum(float* values, const float* a, size_t size);
+
+    // Name of the selected implementation
+    static const char* GetInstructionSet();
+};
+
+} // namespace flockmtl
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "flockmtl/vector/embedding_scanner.hpp"
+#include "flockmtl/vector/metric.hpp"
+
+namespace flockmtl {
+
+struct KMeansOptions {
+    size_t k = 8;
+    size_t max_iterations = 25;
+    // Rows sampled per iteration by mini-batch k-means, 0 runs the full-batch (Lloyd) algorithm
+    size_t batch_size = 0;
+    // L2, or cosine for spherical k-means over normalized embeddings
+    VectorMetric metric = VectorMetric::L2;
+    uint64_t seed = 42;
+};
+
+struct KMeansResult {
+    size_t dimensions = 0;
+    // `k` centroids of `dimensions` floats each
+    std::vector<float> centroids;
+    std::vector<int64_t> cluster_sizes;
+    // Cluster of every row of the input, and the distance to its centroid
+    std::vector<uint32_t> assignments;
+    std::vector<float> distances;
+    size_t iterations = 0;
+};
+
+// K-means clustering of embeddings held in memory, seeded with k-means++. The rows are assigned to the centroids in
+// parallel, each thread accumulating its own partial sums, and a row is compared with all the centroids at once
+// through the batched inner product kernel.
+class KMeans {
+public:
+    explicit KMeans(KMeansOptions options);
+
+    KMeansResult Run(EmbeddingBlock& data, size_t num_threads) const;
+
+    // Rows assigned by a worker at once
+    constexpr static size_t block_rows = 1024;
+
+private:
+    KMeansOptions options_;
+
+    // Picks the initial centroids among the `candidates` rows with k-means++ sampling
+    void InitializeCentroids(const EmbeddingBlock& data, const std::vector<size_t>& candidates,
+                             std::vector<float>& centroids, std::mt19937_64& random, size_t num_threads) const;
+    // Squared L2 or cosine distance between a row and a seeding candidate
+    float SeedingDistance(const float* row, const float* centroid, size_t dimensions) const;
+    // Closest centroid of a row, with its distance in the internal scale (squared L2 or 1 - cosine)
+    std::pair<uint32_t, float> FindClosest(const float* row, float row_squared_norm,
+                                           const std::vector<float>& centroids,
+                                           const std::vector<float>& centroid_squared_norms, float* scores) const;
+    // Assigns the rows of `data` listed in `rows` (every row when empty) to their closest centroid
+    void Assign(const EmbeddingBlock& data, const std::vector<float>& row_squared_norms,
+                const std::vector<float>& centroids, std::vector<uint32_t>& assignments, std::vector<float>& distances,
+                size_t num_threads, const std::vector<size_t>& rows = {}) const;
+    void Normalize(float* vector, size_t size) const;
+    float ToOutputDistance(float distance) const;
+
+    // Splits [0, count) in blocks processed by `num_threads` threads; `process(worker, begin, end)`
+    static void ParallelFor(size_t count, size_t num_threads,
+                            const std::function<void(size_t, size_t, size_t)>& process);
+};
+
+} // namespace flockmtl
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+namespace flockmtl {
+
+enum class VectorMetric { COSINE, L2, INNER_PRODUCT };
+
+class VectorMetricUtil {
+public:
+    // Accepts 'cosine', 'l2' and 'ip' (or 'inner_product')
+    static VectorMetric FromString(const std::string& metric);
+    static std::string ToString(VectorMetric metric);
+    // Distance between two vectors, lower is closer: 1 - cosine similarity, euclidean distance, or the negated
+    // inner product
+    static float Distance(VectorMetric metric, const float* a, const float* b, size_t size);
+};
+
+} // namespace flockmtl
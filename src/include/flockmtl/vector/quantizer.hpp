@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flockmtl {
+
+// Compact encodings of float32 embeddings, to be scored with the int8 and Hamming kernels of `VectorKernels`
+class Quantizer {
+public:
+    // Scales the vector so its largest absolute value maps to 127. The direction is kept, not the magnitude, so the
+    // codes are compared with cosine similarity.
+    static void QuantizeInt8(const float* vector, size_t size, int8_t* out);
+    // One bit per dimension, set for positive values, packed least significant bit first
+    static void QuantizeBinary(const float* vector, size_t size, uint8_t* out);
+    static size_t GetBinarySize(const size_t dimensions) { return (dimensions + 7) / 8; }
+
+    // Cosine similarity of two int8 codes, 0 when either of them is all zeros
+    static float Int8CosineSimilarity(const int8_t* a, const int8_t* b, size_t size);
+};
+
+} // namespace flockmtl
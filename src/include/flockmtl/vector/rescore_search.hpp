@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "flockmtl/vector/exact_search.hpp"
+
+namespace flockmtl {
+
+// Two step k nearest neighbor search: the rows are ranked on their quantized codes, which are much smaller to scan,
+// then the best `k * oversample` candidates are rescored with their full precision embeddings.
+class RescoreSearch {
+public:
+    RescoreSearch(VectorMetric metric, std::vector<float> query, size_t k, size_t oversample);
+
+    // `quantized_column` holds the output of vector_quantize_binary (BLOB) or vector_quantize_int8 (TINYINT vector)
+    ExactSearch::Result Run(duckdb::Connection& con, const EmbeddingSource& source,
+                            const std::string& quantized_column);
+
+private:
+    VectorMetric metric_;
+    std::vector<float> query_;
+    size_t k_;
+    size_t oversample_;
+
+    std::vector<int64_t> GetCandidates(duckdb::Connection& con, const EmbeddingSource& source,
+                                       const std::string& quantized_column) const;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "flockmtl/vector/embedding_scanner.hpp"
+#include "flockmtl/vector/metric.hpp"
+
+namespace flockmtl {
+
+struct SimilarityJoinOptions {
+    VectorMetric metric = VectorMetric::COSINE;
+    // Pairs further apart are dropped
+    float max_distance = std::numeric_limits<float>::infinity();
+    // Maximum number of matches per left row, 0 for all of them
+    size_t k = 0;
+};
+
+struct SimilarityMatch {
+    int64_t left_key;
+    int64_t right_key;
+    float distance;
+};
+
+// Joins every row of a left embedding column with the closest rows of a right one, held in memory. The distances
+// are computed as a blocked matrix product over cache sized tiles of both sides, with left blocks spread over
+// threads.
+class SimilarityJoin {
+public:
+    SimilarityJoin(EmbeddingBlock right, SimilarityJoinOptions options);
+
+    // Matches of each left row are returned together, closest first
+    std::vector<SimilarityMatch> Run(EmbeddingScanner& left, size_t num_threads);
+
+    constexpr static size_t block_rows = STANDARD_VECTOR_SIZE;
+    // Bytes of vectors of each side scored together, sized so both tiles stay in the L2 cache
+    constexpr static size_t tile_bytes = 128 * 1024;
+
+private:
+    EmbeddingBlock right_;
+    std::vector<float> right_squared_norms_;
+    SimilarityJoinOptions options_;
+
+    void PrepareVectors(EmbeddingBlock& block, std::vector<float>& squared_norms) const;
+    void JoinBlock(EmbeddingBlock& left, std::vector<SimilarityMatch>& matches) const;
+    float ToDistance(float inner_product, float left_squared_norm, float right_squared_norm) const;
+};
+
+} // namespace flockmtl
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "flockmtl/core/common.hpp"
+#include "flockmtl/vector/hnsw.hpp"
+
+namespace flockmtl {
+
+struct VectorIndexDefinition {
+    std::string index_name;
+    std::string table_name;
+    std::string key_column;
+    std::string embedding_column;
+    VectorMetric metric = VectorMetric::COSINE;
+    size_t dimensions = 0;
+    size_t m = 16;
+    size_t ef_construction = 200;
+};
+
+// Named HNSW indexes over an embedding column. The graph is persisted in `flockmtl_config` and the vectors are
+// read back from the indexed table, so an index survives restarts without storing the embeddings twice.
+class VectorIndexManager {
+public:
+    // Builds the index over every row of the table and returns the number of indexed rows
+    static size_t Create(VectorIndexDefinition definition, size_t num_threads);
+    // Links the rows inserted or updated since the last build and drops the deleted ones from the results
+    static size_t Refresh(const std::string& index_name, size_t num_threads);
+    static void Drop(const std::string& index_name);
+    // Returns the index, loading it from `flockmtl_config` when it is not cached or changed since
+    static std::shared_ptr<const HnswIndex> Get(const std::string& index_name);
+    static VectorIndexDefinition GetDefinition(const std::string& index_name);
+
+    constexpr static size_t default_ef_search = 64;
+
+private:
+    struct CachedIndex {
+        std::string updated_at;
+        std::shared_ptr<HnswIndex> index;
+    };
+
+    // Past this fraction of deleted rows, a refresh rebuilds the graph instead of routing around them
+    constexpr static double rebuild_deleted_ratio = 0.2;
+
+    static std::mutex cache_mutex_;
+    static std::map<std::string, CachedIndex> cache_;
+
+    static std::string GetDefinitionQuery(const std::string& index_name);
+    // Calls `callback(key, vector)` for every row of the indexed table with a non NULL embedding
+    static void ScanSource(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                           const std::function<void(int64_t, const float*)>& callback);
+    static std::shared_ptr<HnswIndex> Build(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                                            size_t num_threads);
+    static std::shared_ptr<HnswIndex> Load(duckdb::Connection& con, const VectorIndexDefinition& definition);
+    static std::string Save(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                            const HnswIndex& index);
+    static std::string GetUpdatedAt(duckdb::Connection& con, const std::string& index_name);
+};
+
+} // namespace flockmtl
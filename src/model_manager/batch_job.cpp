@@ -0,0 +1,193 @@
+#include "flockmtl/model_manager/batch_job.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#include "filesystem.hpp"
+#include "flockmtl/core/config.hpp"
+
+namespace flockmtl {
+
+BatchJob::BatchJob(IProvider& provider, std::string endpoint, const int32_t poll_interval_seconds)
+    : provider_(provider), endpoint_(std::move(endpoint)), poll_interval_seconds_(std::max(poll_interval_seconds, 1)) {}
+
+std::vector<nlohmann::json> BatchJob::Run(const std::vector<nlohmann::json>& request_bodies) {
+    std::vector<nlohmann::json> results(request_bodies.size());
+    std::vector<size_t> pending(request_bodies.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    auto resume = true;
+    while (!pending.empty()) {
+        std::string requests_jsonl;
+        for (const auto index : pending) {
+            nlohmann::json request = {{"custom_id", std::to_string(index)},
+                                      {"method", "POST"},
+                                      {"url", endpoint_},
+                                      {"body", request_bodies[index]}};
+            requests_jsonl += request.dump() + "\n";
+        }
+        const auto job_key = GetJobKey(requests_jsonl);
+
+        // The same requests may already have been submitted by an earlier run, the job is then picked up where it is
+        auto batch_id = resume ? FindBatch(job_key) : "";
+        const auto submitted = batch_id.empty();
+        if (submitted) {
+            batch_id = Submit(job_key, requests_jsonl);
+        }
+
+        const auto batch = WaitForCompletion(job_key, batch_id);
+        // An expired batch lists the requests it did not get to in its error file; they are sent again instead
+        const auto expired = batch.value("status", "") == "expired";
+        for (const auto& file_field : {"output_file_id", "error_file_id"}) {
+            if (batch.contains(file_field) && batch[file_field].is_string() &&
+                (!expired || std::string(file_field) == "output_file_id")) {
+                CollectResults(batch[file_field].get<std::string>(), results);
+            }
+        }
+        if (!expired) {
+            break;
+        }
+
+        std::vector<size_t> remaining;
+        for (const auto index : pending) {
+            if (results[index].is_null()) {
+                remaining.push_back(index);
+            }
+        }
+        if (submitted && remaining.size() == pending.size()) {
+            throw std::runtime_error(
+                duckdb_fmt::format("The offline batch `{}` expired before completing any request", batch_id));
+        }
+        // A resumed batch that had expired without completing anything is submitted again rather than resumed
+        resume = remaining.size() < pending.size();
+        pending = std::move(remaining);
+    }
+
+    for (auto& result : results) {
+        if (result.is_null()) {
+            result = {{"error", {{"message", "The offline batch returned no result for this request."}}}};
+        }
+    }
+    return results;
+}
+
+std::string BatchJob::FindBatch(const std::string& job_key) const {
+    auto con = Config::GetConnection();
+    const auto state = con.Query(duckdb_fmt::format(" SELECT batch_id, status "
+                                                    "   FROM flockmtl_config.{} "
+                                                    "  WHERE job_key = '{}'; ",
+                                                    Config::get_batch_jobs_table_name(), job_key));
+    if (state->HasError() || state->RowCount() == 0 || IsTerminalFailure(state->GetValue(1, 0).ToString())) {
+        return "";
+    }
+    return state->GetValue(0, 0).ToString();
+}
+
+std::string BatchJob::GetJobKey(const std::string& requests_jsonl) const {
+    // FNV-1a, stable across runs so an interrupted query finds its job again
+    uint64_t hash = 14695981039346656037ULL;
+    const auto identity = provider_.model_details_.provider_name + "\n" + provider_.model_details_.model + "\n" +
+                          endpoint_ + "\n" + requests_jsonl;
+    for (const auto c : identity) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return duckdb_fmt::format("{:016x}", hash);
+}
+
+std::string BatchJob::Submit(const std::string& job_key, const std::string& requests_jsonl) {
+    const auto requests_file_path =
+        (std::filesystem::temp_directory_path() / ("flockmtl_batch_" + job_key + ".jsonl")).string();
+    {
+        std::ofstream requests_file(requests_file_path, std::ios::binary | std::ios::trunc);
+        requests_file << requests_jsonl;
+    }
+
+    std::string batch_id;
+    try {
+        batch_id = provider_.SubmitBatch(requests_file_path, endpoint_);
+    } catch (...) {
+        std::filesystem::remove(requests_file_path);
+        throw;
+    }
+    std::filesystem::remove(requests_file_path);
+
+    SaveState(job_key, batch_id, "submitted", "");
+    return batch_id;
+}
+
+nlohmann::json BatchJob::WaitForCompletion(const std::string& job_key, const std::string& batch_id) {
+    std::string last_status;
+    while (true) {
+        auto batch = provider_.RetrieveBatch(batch_id);
+        const auto status = batch.value("status", "");
+        const auto output_file_id = batch.contains("output_file_id") && batch["output_file_id"].is_string()
+                                        ? batch["output_file_id"].get<std::string>()
+                                        : "";
+        if (status != last_status) {
+            SaveState(job_key, batch_id, status, output_file_id);
+            last_status = status;
+        }
+
+        // An expired batch still carries the results of the requests that finished in time
+        if (status == "completed" || status == "expired") {
+            return batch;
+        }
+        if (IsTerminalFailure(status)) {
+            throw std::runtime_error(duckdb_fmt::format("The offline batch `{}` ended with status `{}`: {}", batch_id,
+                                                        status, batch.contains("errors") ? batch["errors"].dump() : ""));
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(poll_interval_seconds_));
+    }
+}
+
+void BatchJob::CollectResults(const std::string& file_id, std::vector<nlohmann::json>& results) {
+    std::istringstream lines(provider_.DownloadFile(file_id));
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        const auto entry = nlohmann::json::parse(line);
+        const auto index = std::stoull(entry.value("custom_id", "0"));
+        if (index >= results.size()) {
+            continue;
+        }
+
+        const auto& response = entry.contains("response") && entry["response"].is_object() ? entry["response"]
+                                                                                             : nlohmann::json::object();
+        if (response.value("status_code", 0) == 200) {
+            results[index] = response["body"];
+        } else if (entry.contains("error") && !entry["error"].is_null()) {
+            results[index] = {{"error", entry["error"]}};
+        } else {
+            results[index] = {{"error", response.contains("body") ? response["body"].value("error", response["body"])
+                                                                  : nlohmann::json("Unknown batch request error")}};
+        }
+    }
+}
+
+bool BatchJob::IsTerminalFailure(const std::string& status) {
+    return status == "failed" || status == "cancelled" || status == "cancelling";
+}
+
+void BatchJob::SaveState(const std::string& job_key, const std::string& batch_id, const std::string& status,
+                         const std::string& output_file_id) const {
+    auto con = Config::GetConnection();
+    const auto result = con.Query(duckdb_fmt::format(
+        " INSERT OR REPLACE INTO flockmtl_config.{} "
+        " (job_key, provider_name, model, endpoint, batch_id, status, output_file_id, updated_at) "
+        " VALUES ('{}', '{}', '{}', '{}', '{}', '{}', '{}', CURRENT_TIMESTAMP); ",
+        Config::get_batch_jobs_table_name(), job_key, provider_.model_details_.provider_name,
+        provider_.model_details_.model, endpoint_, batch_id, status, output_file_id));
+    // Without its state, a re-run of the query would pay for the same batch again
+    if (result->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to save the state of the offline batch `{}`: {}", batch_id,
+                                                    result->GetError()));
+    }
+}
+
+} // namespace flockmtl
@@ -0,0 +1,221 @@
+#include "flockmtl/model_manager/completion_stream.hpp"
+
+#include <stdexcept>
+
+namespace flockmtl {
+
+TupleStreamParser::TupleStreamParser(std::function<void(nlohmann::json)> on_tuple) : on_tuple_(std::move(on_tuple)) {}
+
+void TupleStreamParser::ThrowMalformed(const std::string& reason) {
+    throw std::runtime_error("The response is not a valid JSON object of tuples: " + reason);
+}
+
+void TupleStreamParser::Feed(const std::string_view text) {
+    for (const auto c : text) {
+        if (tuples_closed_) {
+            // The rest of the root object is not needed
+            return;
+        }
+        Consume(c);
+    }
+}
+
+void TupleStreamParser::Consume(const char c) {
+    // Depth of the tuples array: inside the root object, itself inside nothing
+    constexpr size_t tuples_depth = 2;
+    const auto in_tuple = in_tuples_ && nesting_.size() >= tuples_depth;
+
+    if (in_string_) {
+        if (escaped_) {
+            escaped_ = false;
+        } else if (c == '\\') {
+            escaped_ = true;
+        } else if (c == '"') {
+            in_string_ = false;
+        }
+        if (in_tuple) {
+            tuple_ += c;
+        } else if (in_string_ && nesting_.size() == 1) {
+            last_string_ += c;
+        }
+        return;
+    }
+
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        if (in_tuple && !tuple_.empty()) {
+            tuple_ += c;
+        }
+        return;
+    }
+    if (nesting_.empty()) {
+        if (c != '{') {
+            ThrowMalformed(std::string("unexpected character '") + c + "' before the root object");
+        }
+        nesting_.push_back(c);
+        return;
+    }
+    if (in_tuple && nesting_.size() == tuples_depth && (c == ',' || c == ']')) {
+        // A separator at the level of the array closes the current tuple
+        if (!tuple_.empty()) {
+            EmitTuple();
+        } else if (c == ',') {
+            ThrowMalformed("empty tuple");
+        }
+        if (c == ']') {
+            nesting_.pop_back();
+            tuples_closed_ = true;
+        }
+        return;
+    }
+
+    if (c == '"') {
+        in_string_ = true;
+        if (nesting_.size() == 1) {
+            last_string_.clear();
+        }
+    } else if (c == '[' && nesting_.size() == 1 && !in_tuples_) {
+        if (last_string_ != "tuples") {
+            ThrowMalformed("expected the `tuples` array, found `" + last_string_ + "`");
+        }
+        in_tuples_ = true;
+        nesting_.push_back(c);
+        return;
+    } else if (c == '{' || c == '[') {
+        nesting_.push_back(c);
+    } else if (c == '}' || c == ']') {
+        if (nesting_.back() != (c == '}' ? '{' : '[')) {
+            ThrowMalformed(std::string("unbalanced '") + c + "'");
+        }
+        nesting_.pop_back();
+        if (nesting_.empty()) {
+            ThrowMalformed("the root object has no `tuples` array");
+        }
+    }
+    if (in_tuple) {
+        tuple_ += c;
+    }
+}
+
+void TupleStreamParser::EmitTuple() {
+    auto tuple = nlohmann::json::parse(tuple_, nullptr, false);
+    if (tuple.is_discarded()) {
+        ThrowMalformed("invalid tuple `" + tuple_ + "`");
+    }
+    tuple_.clear();
+    on_tuple_(std::move(tuple));
+}
+
+void TupleStreamParser::CheckComplete() const {
+    if (!tuples_closed_) {
+        ThrowMalformed("the response ended before the array of tuples was closed");
+    }
+}
+
+CompletionStream::CompletionStream(const Format format, std::function<void(nlohmann::json)> on_tuple)
+    : format_(format), tuples_(std::move(on_tuple)) {}
+
+void CompletionStream::Feed(const char* data, const size_t size) {
+    const std::string_view chunk(data, size);
+    size_t begin = 0;
+    for (auto end = chunk.find('\n'); end != std::string_view::npos; end = chunk.find('\n', begin)) {
+        if (line_.empty()) {
+            ProcessLine(chunk.substr(begin, end - begin));
+        } else {
+            line_.append(chunk.substr(begin, end - begin));
+            ProcessLine(line_);
+            line_.clear();
+        }
+        begin = end + 1;
+    }
+    line_.append(chunk.substr(begin));
+}
+
+const CompletionResponse& CompletionStream::Finish() {
+    if (!line_.empty()) {
+        ProcessLine(line_);
+        line_.clear();
+    }
+    // A server-sent event is dispatched on the blank line that follows it, which the body may not end with
+    ProcessLine("");
+    return result_;
+}
+
+void CompletionStream::ProcessLine(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (format_ == Format::NDJSON) {
+        if (!line.empty()) {
+            ProcessEvent(std::string(line));
+        }
+        return;
+    }
+
+    if (line.empty()) {
+        if (!event_data_.empty()) {
+            ProcessEvent(event_data_);
+            event_data_.clear();
+        }
+        return;
+    }
+    // Only the data field matters; comments (": ...") and the event, id and retry fields are ignored
+    if (line.substr(0, 5) == "data:") {
+        auto data = line.substr(5);
+        if (!data.empty() && data.front() == ' ') {
+            data.remove_prefix(1);
+        }
+        if (!event_data_.empty()) {
+            event_data_ += '\n';
+        }
+        event_data_.append(data);
+    }
+}
+
+void CompletionStream::ProcessEvent(const std::string& payload) {
+    if (payload == "[DONE]") {
+        return;
+    }
+    const auto event = nlohmann::json::parse(payload, nullptr, false);
+    if (event.is_discarded()) {
+        throw std::runtime_error("Received an invalid event in the response stream: " + payload);
+    }
+    if (event.contains("error")) {
+        throw std::runtime_error(event["error"].dump());
+    }
+
+    if (format_ == Format::NDJSON) {
+        if (const auto it = event.find("response"); it != event.end() && it->is_string()) {
+            tuples_.Feed(it->get_ref<const std::string&>());
+        }
+        if (event.value("done", false)) {
+            result_.finish_reason = event.value("done_reason", "stop");
+            result_.prompt_tokens = event.value("prompt_eval_count", 0);
+            result_.completion_tokens = event.value("eval_count", 0);
+        }
+        return;
+    }
+
+    if (const auto usage = event.find("usage"); usage != event.end() && usage->is_object()) {
+        result_.prompt_tokens = usage->value("prompt_tokens", 0);
+        result_.completion_tokens = usage->value("completion_tokens", 0);
+    }
+    const auto choices = event.find("choices");
+    if (choices == event.end() || !choices->is_array() || choices->empty()) {
+        return;
+    }
+    const auto& choice = choices->front();
+    if (const auto delta = choice.find("delta"); delta != choice.end() && delta->is_object()) {
+        if (const auto content = delta->find("content"); content != delta->end() && content->is_string()) {
+            tuples_.Feed(content->get_ref<const std::string&>());
+        }
+        if (const auto refusal = delta->find("refusal"); refusal != delta->end() && refusal->is_string()) {
+            result_.refusal += refusal->get_ref<const std::string&>();
+        }
+    }
+    if (const auto finish_reason = choice.find("finish_reason");
+        finish_reason != choice.end() && finish_reason->is_string()) {
+        result_.finish_reason = finish_reason->get<std::string>();
+    }
+}
+
+} // namespace flockmtl
@@ -0,0 +1,81 @@
+#include "flockmtl/model_manager/embedding_batcher.hpp"
+
+#include <atomic>
+#include <future>
+#include <iterator>
+
+#include "flockmtl/model_manager/tiktoken.hpp"
+
+namespace flockmtl {
+
+std::vector<std::pair<size_t, size_t>> EmbeddingBatcher::Split(const std::vector<std::string>& inputs,
+                                                               const EmbeddingBatchLimits& limits) {
+    std::vector<std::pair<size_t, size_t>> batches;
+    size_t start_index = 0;
+    int64_t batch_tokens = 0;
+    for (size_t index = 0; index < inputs.size(); index++) {
+        const auto num_tokens = static_cast<int64_t>(Tiktoken::GetNumTokens(inputs[index]));
+        const auto batch_items = index - start_index;
+        // An input larger than the token budget still goes out, alone in its own request
+        if (batch_items > 0 && ((limits.max_items > 0 && batch_items >= limits.max_items) ||
+                                (limits.max_tokens > 0 && batch_tokens + num_tokens > limits.max_tokens))) {
+            batches.emplace_back(start_index, index);
+            start_index = index;
+            batch_tokens = 0;
+        }
+        batch_tokens += num_tokens;
+    }
+    if (start_index < inputs.size()) {
+        batches.emplace_back(start_index, inputs.size());
+    }
+    return batches;
+}
+
+std::vector<std::vector<float>> EmbeddingBatcher::Run(const std::vector<std::string>& inputs,
+                                                      const EmbeddingBatchLimits& limits, const EmbedFunction& embed) {
+    const auto batches = Split(inputs, limits);
+    std::vector<std::vector<std::vector<float>>> batch_embeddings(batches.size());
+
+    std::atomic<size_t> next_batch {0};
+    std::atomic<bool> failed {false};
+    auto worker = [&]() {
+        for (auto batch_index = next_batch++; batch_index < batches.size() && !failed; batch_index = next_batch++) {
+            const auto [start_index, end_index] = batches[batch_index];
+            try {
+                batch_embeddings[batch_index] = embed(std::vector<std::string>(
+                    inputs.begin() + static_cast<std::ptrdiff_t>(start_index),
+                    inputs.begin() + static_cast<std::ptrdiff_t>(end_index)));
+                if (batch_embeddings[batch_index].size() != end_index - start_index) {
+                    throw std::runtime_error(duckdb_fmt::format("Expected {} embeddings in the response, got {}",
+                                                                end_index - start_index,
+                                                                batch_embeddings[batch_index].size()));
+                }
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+        }
+    };
+
+    const auto num_workers = std::min(std::max<size_t>(limits.max_concurrency, 1), batches.size());
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < num_workers; i++) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    // Every worker has to finish before the first error is rethrown, they reference this frame
+    for (auto& w : workers) {
+        w.wait();
+    }
+    for (auto& w : workers) {
+        w.get();
+    }
+
+    std::vector<std::vector<float>> embeddings;
+    embeddings.reserve(inputs.size());
+    for (auto& batch : batch_embeddings) {
+        std::move(batch.begin(), batch.end(), std::back_inserter(embeddings));
+    }
+    return embeddings;
+}
+
+} // namespace flockmtl
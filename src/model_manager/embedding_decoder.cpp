@@ -0,0 +1,65 @@
+#include "flockmtl/model_manager/embedding_decoder.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace flockmtl {
+
+std::vector<float> EmbeddingDecoder::Decode(const nlohmann::json& embedding) {
+    if (embedding.is_string()) {
+        return DecodeBase64(embedding.get_ref<const std::string&>());
+    }
+
+    std::vector<float> values;
+    values.reserve(embedding.size());
+    for (const auto& value : embedding) {
+        values.push_back(value.get<float>());
+    }
+    return values;
+}
+
+std::vector<float> EmbeddingDecoder::DecodeBase64(const std::string& encoded) {
+    static const auto decoding_table = []() {
+        std::array<int8_t, 256> table {};
+        table.fill(-1);
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (size_t i = 0; i < alphabet.size(); i++) {
+            table[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+        }
+        return table;
+    }();
+
+    std::vector<float> values((encoded.size() / 4) * 3 / sizeof(float));
+    auto* bytes = reinterpret_cast<unsigned char*>(values.data());
+    const auto capacity = values.size() * sizeof(float);
+
+    size_t size = 0;
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (const auto c : encoded) {
+        if (c == '=') {
+            break;
+        }
+        const auto sextet = decoding_table[static_cast<unsigned char>(c)];
+        if (sextet < 0) {
+            throw std::runtime_error("Invalid character in base64 encoded embedding");
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(sextet);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (size == capacity) {
+                throw std::runtime_error("The base64 encoded embedding is not a sequence of float32 values");
+            }
+            bytes[size++] = static_cast<unsigned char>((buffer >> bits) & 0xFF);
+        }
+    }
+    if (size != capacity) {
+        throw std::runtime_error("The base64 encoded embedding is not a sequence of float32 values");
+    }
+    // The bytes were written in place, which matches the wire format on the little-endian hosts DuckDB supports
+    return values;
+}
+
+} // namespace flockmtl
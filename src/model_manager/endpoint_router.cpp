@@ -0,0 +1,65 @@
+#include "flockmtl/model_manager/endpoint_router.hpp"
+
+#include <algorithm>
+
+#include "flockmtl/model_manager/rate_limiter.hpp"
+
+namespace flockmtl {
+
+std::mutex EndpointRouter::mutex_;
+std::map<std::string, EndpointRouter::EndpointStats> EndpointRouter::stats_;
+size_t EndpointRouter::next_ = 0;
+
+EndpointRouter::Lease::Lease(const ModelDetails& model_details)
+    : key_(RateLimiter::GetKey(model_details)), start_(std::chrono::steady_clock::now()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_[key_].in_flight++;
+}
+
+EndpointRouter::Lease::~Lease() {
+    const auto elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stats = stats_[key_];
+    stats.in_flight--;
+    if (!failed_) {
+        stats.latency_ms = stats.latency_ms == 0
+                               ? elapsed_ms
+                               : (1 - latency_smoothing) * stats.latency_ms + latency_smoothing * elapsed_ms;
+    }
+}
+
+size_t EndpointRouter::Select(const std::vector<std::shared_ptr<IProvider>>& endpoints,
+                              const std::vector<bool>& tried) {
+    if (endpoints.size() == 1) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Ties are broken round-robin, by starting the scan one endpoint further every time
+    const auto start = next_++;
+    auto best = endpoints.size();
+    auto best_ejected = true;
+    auto best_cost = 0.0;
+    for (size_t offset = 0; offset < endpoints.size(); offset++) {
+        const auto index = (start + offset) % endpoints.size();
+        if (tried[index]) {
+            continue;
+        }
+        const auto& model_details = endpoints[index]->model_details_;
+        const auto rate_limiter = RateLimiter::Get(model_details);
+        const auto ejected = rate_limiter->IsEjected();
+        const auto& stats = stats_[RateLimiter::GetKey(model_details)];
+        // Endpoints that have not answered yet look the fastest, so that every endpoint gets measured
+        const auto cost = static_cast<double>(stats.in_flight + 1) * (stats.latency_ms + 1) /
+                          std::max(rate_limiter->GetHeadroom(), min_headroom);
+        if (best == endpoints.size() || (best_ejected && !ejected) || (best_ejected == ejected && cost < best_cost)) {
+            best = index;
+            best_ejected = ejected;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+} // namespace flockmtl
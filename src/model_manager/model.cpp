@@ -1,9 +1,13 @@
 #include "flockmtl/model_manager/model.hpp"
 #include "flockmtl/secret_manager/secret_manager.hpp"
 
+#include <sstream>
+
 namespace flockmtl {
 
-Model::Model(const nlohmann::json& model_json) {
+Model::Model(const nlohmann::json& model_json) : Model(model_json, RequestScheduler::GetCurrentOrigin()) {}
+
+Model::Model(const nlohmann::json& model_json, const RequestOrigin& origin) : origin_(origin) {
     LoadModelDetails(model_json);
     ConstructProvider();
 }
@@ -14,26 +18,131 @@ void Model::LoadModelDetails(const nlohmann::json& model_json) {
         throw std::invalid_argument("`model_name` is required in model settings");
     }
     auto query_result = GetQueriedModel(model_details_.model_name);
+    const auto& model_args = std::get<2>(query_result);
     model_details_.model =
         model_json.contains("model") ? model_json.at("model").get<std::string>() : std::get<0>(query_result);
     model_details_.provider_name =
         model_json.contains("provider") ? model_json.at("provider").get<std::string>() : std::get<1>(query_result);
-    auto secret_name = "__default_" + model_details_.provider_name;
-    if (model_details_.provider_name == AZURE)
-        secret_name += "_llm";
-    if (model_json.contains("secret_name")) {
-        secret_name = model_json["secret_name"].get<std::string>();
-    }
-    model_details_.secret = SecretManager::GetSecret(secret_name);
-    model_details_.context_window =
-        model_json.contains("context_window") ? model_json.at("context_window").get<int>() : std::get<2>(query_result);
+    LoadSecrets(model_json, model_args);
+    model_details_.context_window = model_json.contains("context_window")
+                                        ? model_json.at("context_window").get<int>()
+                                        : model_args.at("context_window").get<int>();
     model_details_.max_output_tokens = model_json.contains("max_output_tokens")
                                            ? model_json.at("max_output_tokens").get<int>()
-                                           : std::get<3>(query_result);
+                                           : model_args.at("max_output_tokens").get<int>();
     model_details_.temperature = model_json.contains("temperature") ? model_json.at("temperature").get<float>() : 0.5;
+    LoadRetryPolicy(model_json, model_args);
+    LoadRateLimits(model_json, model_args);
+    LoadExecutionMode(model_json, model_args);
+    LoadDimensions(model_json, model_args);
+}
+
+void Model::LoadSecrets(const nlohmann::json& model_json, const nlohmann::json& model_args) {
+    secret_names_.clear();
+    const auto value = GetModelArgument(model_json, model_args, "secret_name");
+    if (value.is_array()) {
+        for (const auto& secret_name : value) {
+            secret_names_.push_back(secret_name.get<std::string>());
+        }
+    } else if (!value.is_null()) {
+        // A comma separated list of secrets makes a pool of endpoints and keys for the same model
+        std::stringstream secret_names(value.is_string() ? value.get<std::string>() : value.dump());
+        std::string secret_name;
+        while (std::getline(secret_names, secret_name, ',')) {
+            const auto begin = secret_name.find_first_not_of(" \t");
+            if (begin != std::string::npos) {
+                secret_names_.push_back(secret_name.substr(begin, secret_name.find_last_not_of(" \t") - begin + 1));
+            }
+        }
+    }
+    if (secret_names_.empty()) {
+        auto secret_name = "__default_" + model_details_.provider_name;
+        if (model_details_.provider_name == AZURE)
+            secret_name += "_llm";
+        secret_names_.push_back(secret_name);
+    }
+    model_details_.secret_name = secret_names_.front();
+    model_details_.secret = SecretManager::GetSecret(secret_names_.front());
+}
+
+void Model::LoadRetryPolicy(const nlohmann::json& model_json, const nlohmann::json& model_args) {
+    if (const auto value = GetModelArgument(model_json, model_args, "max_retries"); !value.is_null()) {
+        model_details_.retry_policy.max_retries = value.get<int32_t>();
+    }
+    if (const auto value = GetModelArgument(model_json, model_args, "retry_base_delay_ms"); !value.is_null()) {
+        model_details_.retry_policy.base_delay_ms = value.get<int32_t>();
+    }
+    if (const auto value = GetModelArgument(model_json, model_args, "retry_max_delay_ms"); !value.is_null()) {
+        model_details_.retry_policy.max_delay_ms = value.get<int32_t>();
+    }
+}
+
+void Model::LoadRateLimits(const nlohmann::json& model_json, const nlohmann::json& model_args) {
+    const auto requests_per_minute = GetModelArgument(model_json, model_args, "requests_per_minute");
+    model_details_.requests_per_minute = requests_per_minute.is_null() ? 0 : requests_per_minute.get<int32_t>();
+    const auto tokens_per_minute = GetModelArgument(model_json, model_args, "tokens_per_minute");
+    model_details_.tokens_per_minute = tokens_per_minute.is_null() ? 0 : tokens_per_minute.get<int32_t>();
+    const auto max_concurrent_requests = GetModelArgument(model_json, model_args, "max_concurrent_requests");
+    model_details_.max_concurrent_requests =
+        max_concurrent_requests.is_null() ? 0 : max_concurrent_requests.get<int32_t>();
+}
+
+void Model::LoadExecutionMode(const nlohmann::json& model_json, const nlohmann::json& model_args) {
+    model_details_.offline_execution = false;
+    if (const auto value = GetModelArgument(model_json, model_args, "execution_mode"); !value.is_null()) {
+        const auto execution_mode = value.get<std::string>();
+        if (execution_mode != "online" && execution_mode != "offline") {
+            throw std::invalid_argument(duckdb_fmt::format(
+                "Unsupported execution_mode `{}`, expected `online` or `offline`", execution_mode));
+        }
+        model_details_.offline_execution = execution_mode == "offline";
+    }
+    const auto poll_interval = GetModelArgument(model_json, model_args, "batch_poll_interval_seconds");
+    model_details_.batch_poll_interval_seconds =
+        poll_interval.is_null() ? default_batch_poll_interval_seconds : poll_interval.get<int32_t>();
+    const auto stream = GetModelArgument(model_json, model_args, "stream");
+    model_details_.stream = !stream.is_null() && stream.get<bool>();
+}
+
+void Model::LoadDimensions(const nlohmann::json& model_json, const nlohmann::json& model_args) {
+    // Native sizes of the embedding models known out of the box
+    static const std::unordered_map<std::string, int32_t> default_dimensions = {
+        {"text-embedding-3-small", 1536}, {"text-embedding-3-large", 3072}, {"text-embedding-ada-002", 1536}};
+    const auto it = default_dimensions.find(model_details_.model);
+    const auto native_dimensions = it != default_dimensions.end() ? it->second : 0;
+    model_details_.dimensions = native_dimensions;
+    model_details_.reduced_dimensions = false;
+
+    if (const auto value = GetModelArgument(model_json, model_args, "dimensions"); !value.is_null()) {
+        model_details_.dimensions = value.get<int32_t>();
+        if (model_details_.dimensions <= 0) {
+            throw std::invalid_argument(
+                duckdb_fmt::format("Invalid dimensions `{}`, expected a positive number", model_details_.dimensions));
+        }
+        // Only the text-embedding-3 models accept a size, and other models only declare the size they return
+        model_details_.reduced_dimensions = model_details_.model.find("text-embedding-3") != std::string::npos &&
+                                            model_details_.dimensions != native_dimensions;
+    }
+}
+
+nlohmann::json Model::GetModelArgument(const nlohmann::json& model_json, const nlohmann::json& model_args,
+                                       const std::string& key) {
+    if (model_json.contains(key)) {
+        // Values of the model struct arrive as strings, so numbers have to be parsed back
+        const auto& value = model_json.at(key);
+        if (value.is_string()) {
+            auto parsed = nlohmann::json::parse(value.get<std::string>(), nullptr, false);
+            return parsed.is_discarded() ? value : parsed;
+        }
+        return value;
+    }
+    if (model_args.contains(key)) {
+        return model_args.at(key);
+    }
+    return nullptr;
 }
 
-std::tuple<std::string, std::string, int32_t, int32_t> Model::GetQueriedModel(const std::string& model_name) {
+std::tuple<std::string, std::string, nlohmann::json> Model::GetQueriedModel(const std::string& model_name) {
     const std::string query =
         duckdb_fmt::format(" SELECT model, provider_name, model_args "
                            " FROM flockmtl_storage.flockmtl_config.FLOCKMTL_MODEL_USER_DEFINED_INTERNAL_TABLE"
@@ -63,31 +172,110 @@ std::tuple<std::string, std::string, int32_t, int32_t> Model::GetQueriedModel(co
     auto provider_name = query_result->GetValue(1, 0).ToString();
     auto model_args = nlohmann::json::parse(query_result->GetValue(2, 0).ToString());
 
-    return {model, provider_name, model_args["context_window"], model_args["max_output_tokens"]};
+    return {model, provider_name, model_args};
 }
 
 void Model::ConstructProvider() {
-    switch (auto provider = GetProviderType(model_details_.provider_name)) {
+    providers_.clear();
+    for (const auto& secret_name : secret_names_) {
+        auto endpoint_details = model_details_;
+        if (secret_name != model_details_.secret_name) {
+            endpoint_details.secret_name = secret_name;
+            endpoint_details.secret = SecretManager::GetSecret(secret_name);
+        }
+        providers_.push_back(CreateProvider(endpoint_details));
+    }
+    // Offline batch jobs and the provider limits always go through the first endpoint of the pool
+    provider_ = providers_.front();
+}
+
+std::shared_ptr<IProvider> Model::CreateProvider(const ModelDetails& model_details) {
+    switch (GetProviderType(model_details.provider_name)) {
     case FLOCKMTL_OPENAI:
-        provider_ = std::make_shared<OpenAIProvider>(model_details_);
-        break;
+        return std::make_shared<OpenAIProvider>(model_details);
     case FLOCKMTL_AZURE:
-        provider_ = std::make_shared<AzureProvider>(model_details_);
-        break;
+        return std::make_shared<AzureProvider>(model_details);
     case FLOCKMTL_OLLAMA:
-        provider_ = std::make_shared<OllamaProvider>(model_details_);
-        break;
+        return std::make_shared<OllamaProvider>(model_details);
     default:
-        throw std::invalid_argument(duckdb_fmt::format("Unsupported provider: {}", model_details_.provider_name));
+        throw std::invalid_argument(duckdb_fmt::format("Unsupported provider: {}", model_details.provider_name));
+    }
+}
+
+void Model::CallRouted(const std::function<void(IProvider&)>& call, const bool failover) {
+    std::vector<bool> tried(providers_.size(), false);
+    for (size_t attempt = 1;; attempt++) {
+        const auto index = EndpointRouter::Select(providers_, tried);
+        tried[index] = true;
+        auto& provider = *providers_[index];
+        EndpointRouter::Lease lease(provider.model_details_);
+        try {
+            call(provider);
+            return;
+        } catch (const EndpointUnavailableError&) {
+            lease.Fail();
+            // Only a failure that got the endpoint ejected by this very request is worth sending to another one
+            if (!failover || attempt == providers_.size()) {
+                throw;
+            }
+        } catch (...) {
+            lease.Fail();
+            throw;
+        }
     }
 }
 
 ModelDetails Model::GetModelDetails() { return model_details_; }
 
+TokenUsage Model::GetLastUsage() { return IProvider::last_usage_; }
+
+EmbeddingBatchLimits Model::GetEmbeddingBatchLimits() { return provider_->GetEmbeddingBatchLimits(); }
+
 nlohmann::json Model::CallComplete(const std::string& prompt, bool json_response) {
-    return provider_->CallComplete(prompt, json_response);
+    RequestScheduler::Admission admission(model_details_, origin_);
+    nlohmann::json response;
+    CallRouted([&](IProvider& provider) { response = provider.CallComplete(prompt, json_response); });
+    return response;
+}
+
+void Model::CallCompleteStream(const std::string& prompt, const std::function<void(nlohmann::json)>& on_tuple) {
+    RequestScheduler::Admission admission(model_details_, origin_);
+    // The tuples already handed out cannot be taken back, so a failed stream is not sent again elsewhere
+    CallRouted([&](IProvider& provider) { provider.CallCompleteStream(prompt, on_tuple); }, false);
+}
+
+std::vector<nlohmann::json> Model::CallCompleteOffline(const std::vector<std::string>& prompts,
+                                                       const bool json_response) {
+    std::vector<nlohmann::json> request_bodies;
+    request_bodies.reserve(prompts.size());
+    for (const auto& prompt : prompts) {
+        request_bodies.push_back(provider_->GetCompletionPayload(prompt, json_response));
+    }
+
+    BatchJob job(*provider_, BatchJob::CHAT_COMPLETIONS_ENDPOINT, model_details_.batch_poll_interval_seconds);
+    auto completions = job.Run(request_bodies);
+
+    std::vector<nlohmann::json> responses;
+    responses.reserve(completions.size());
+    for (const auto& completion : completions) {
+        if (completion.contains("error")) {
+            throw std::runtime_error(
+                duckdb_fmt::format("Error in offline batch request: {}", completion["error"].dump()));
+        }
+        try {
+            responses.push_back(provider_->ParseCompletion(completion, json_response));
+        } catch (const ExceededMaxOutputTokensError&) {
+            responses.push_back(nullptr);
+        }
+    }
+    return responses;
 }
 
-nlohmann::json Model::CallEmbedding(const std::vector<std::string>& inputs) { return provider_->CallEmbedding(inputs); }
+std::vector<std::vector<float>> Model::CallEmbedding(const std::vector<std::string>& inputs) {
+    RequestScheduler::Admission admission(model_details_, origin_);
+    std::vector<std::vector<float>> embeddings;
+    CallRouted([&](IProvider& provider) { embeddings = provider.CallEmbedding(inputs); });
+    return embeddings;
+}
 
 } // namespace flockmtl
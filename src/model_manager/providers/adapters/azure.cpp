@@ -1,12 +1,17 @@
 #include "flockmtl/model_manager/providers/adapters/azure.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
 
 namespace flockmtl {
 
-nlohmann::json AzureProvider::CallComplete(const std::string& prompt, const bool json_response) {
-    auto azure_model_manager_uptr =
-        std::make_unique<AzureModelManager>(model_details_.secret["api_key"], model_details_.secret["resource_name"],
-                                            model_details_.model, model_details_.secret["api_version"], true);
+std::unique_ptr<AzureModelManager> AzureProvider::CreateClient() {
+    const auto& secret = model_details_.secret;
+    auto azure_model_manager_uptr = std::make_unique<AzureModelManager>(
+        secret.at("api_key"), secret.at("resource_name"), model_details_.model, secret.at("api_version"), true);
+    azure_model_manager_uptr->setRetryPolicy(model_details_.retry_policy);
+    return azure_model_manager_uptr;
+}
 
+nlohmann::json AzureProvider::GetCompletionRequest(const std::string& prompt, const bool json_response) const {
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"model", model_details_.model},
                                       {"messages", {{{"role", "user"}, {"content", prompt}}}},
@@ -18,65 +23,57 @@ nlohmann::json AzureProvider::CallComplete(const std::string& prompt, const bool
         request_payload["response_format"] = {{"type", "json_object"}};
     }
 
-    // Make a request to the Azure API
-    auto completion = azure_model_manager_uptr->CallComplete(request_payload);
+    return request_payload;
+}
 
-    // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
-        // Handle the error when the context window is too long
-        throw ExceededMaxOutputTokensError();
-    }
+nlohmann::json AzureProvider::CallComplete(const std::string& prompt, const bool json_response) {
+    auto azure_model_manager_uptr = CreateClient();
+    azure_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_),
+                                             Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
 
-    // Check if the safety system refused the request
-    if (completion["choices"][0]["message"]["refusal"] != nullptr) {
-        // Handle refusal error
-        throw std::runtime_error(
-            duckdb_fmt::format("The request was refused due to Azure's safety system.{{\"refusal\": \"{}\"}}",
-                               completion["choices"][0]["message"]["refusal"].get<std::string>()));
-    }
+    // Make a request to the Azure API, reading only the fields needed from the response
+    ChatCompletionParser parser;
+    azure_model_manager_uptr->CallComplete(GetCompletionRequest(prompt, json_response), parser);
 
-    // Check if the model's output included restricted content
-    if (completion["choices"][0]["finish_reason"] == "content_filter") {
-        // Handle content filtering
-        throw std::runtime_error("The content filter was triggered, resulting in incomplete JSON.");
-    }
+    return FinishCompletion(parser.response, json_response, "Azure");
+}
 
-    std::string content_str = completion["choices"][0]["message"]["content"];
+void AzureProvider::CallCompleteStream(const std::string& prompt,
+                                       const std::function<void(nlohmann::json)>& on_tuple) {
+    auto azure_model_manager_uptr = CreateClient();
+    azure_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_),
+                                             Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
 
-    if (json_response) {
-        return nlohmann::json::parse(content_str);
-    }
+    // Older API versions reject `stream_options`, so the usage is not requested and may be missing
+    auto request_payload = GetCompletionRequest(prompt, true);
+    request_payload["stream"] = true;
+
+    CompletionStream stream(CompletionStream::Format::SERVER_SENT_EVENTS, on_tuple);
+    azure_model_manager_uptr->CallCompleteStream(
+        request_payload, [&stream](const char* data, const size_t size) { stream.Feed(data, size); });
 
-    return content_str;
+    FinishCompletionStream(stream, "Azure");
 }
 
-nlohmann::json AzureProvider::CallEmbedding(const std::vector<std::string>& inputs) {
-    auto azure_model_manager_uptr =
-        std::make_unique<AzureModelManager>(model_details_.secret["api_key"], model_details_.secret["resource_name"],
-                                            model_details_.model, model_details_.secret["api_version"], true);
+std::vector<std::vector<float>> AzureProvider::CallEmbedding(const std::vector<std::string>& inputs) {
+    auto azure_model_manager_uptr = CreateClient();
+    azure_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_), Tiktoken::GetNumTokens(inputs));
 
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {
         {"model", model_details_.model},
         {"input", inputs},
+        {"encoding_format", "base64"},
     };
-
-    // Make a request to the Azure API
-    auto completion = azure_model_manager_uptr->CallEmbedding(request_payload);
-
-    // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
-        // Handle the error when the context window is too long
-        throw ExceededMaxOutputTokensError();
-        // Add error handling code here
+    if (model_details_.reduced_dimensions) {
+        request_payload["dimensions"] = model_details_.dimensions;
     }
 
-    auto embeddings = nlohmann::json::array();
-    for (auto& item : completion["data"]) {
-        embeddings.push_back(item["embedding"]);
-    }
+    // Make a request to the Azure API, decoding the embeddings as they are read
+    EmbeddingParser parser;
+    azure_model_manager_uptr->CallEmbedding(request_payload, parser);
 
-    return embeddings;
+    return std::move(parser.embeddings);
 }
 
 } // namespace flockmtl
\ No newline at end of file
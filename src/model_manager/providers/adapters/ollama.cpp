@@ -1,14 +1,14 @@
 #include "flockmtl/model_manager/providers/adapters/ollama.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
 
 namespace flockmtl {
 
-nlohmann::json OllamaProvider::CallComplete(const std::string& prompt, const bool json_response) {
-    auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret["api_url"], true);
-
+nlohmann::json OllamaProvider::GetCompletionRequest(const std::string& prompt, const bool json_response,
+                                                    const bool stream) const {
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"model", model_details_.model},
                                       {"prompt", prompt},
-                                      {"stream", false},
+                                      {"stream", stream},
                                       {"options",
                                        {
                                            {"temperature", model_details_.temperature},
@@ -21,50 +21,84 @@ nlohmann::json OllamaProvider::CallComplete(const std::string& prompt, const boo
         request_payload["format"] = "json";
     }
 
-    nlohmann::json completion;
+    return request_payload;
+}
+
+nlohmann::json OllamaProvider::CallComplete(const std::string& prompt, const bool json_response) {
+    auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret.at("api_url"), true);
+    ollama_model_manager_uptr->setRetryPolicy(model_details_.retry_policy);
+    ollama_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_),
+                                              Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
+
+    OllamaCompletionParser parser;
     try {
-        completion = ollama_model_manager_uptr->CallComplete(request_payload);
+        ollama_model_manager_uptr->CallComplete(GetCompletionRequest(prompt, json_response, false), parser);
+    } catch (const EndpointUnavailableError&) {
+        throw;
     } catch (const std::exception& e) {
         throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
     }
 
+    auto& completion = parser.response;
+    last_usage_.prompt_tokens = completion.prompt_tokens;
+    last_usage_.completion_tokens = completion.completion_tokens;
+
     // Check if the call was not succesfull
-    if ((completion.contains("done_reason") && completion["done_reason"] != "stop") ||
-        (completion.contains("done") && !completion["done"].is_null() && completion["done"].get<bool>() != true)) {
+    if ((!completion.finish_reason.empty() && completion.finish_reason != "stop") || !parser.done) {
         // Handle refusal error
         throw std::runtime_error("The request was refused due to some internal error with Ollama API");
     }
 
-    std::string content_str = completion["response"];
-
     if (json_response) {
-        return nlohmann::json::parse(content_str);
+        return nlohmann::json::parse(completion.content);
     }
 
-    return content_str;
+    return std::move(completion.content);
 }
 
-nlohmann::json OllamaProvider::CallEmbedding(const std::vector<std::string>& inputs) {
-    auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret["api_url"], true);
-
-    auto embeddings = nlohmann::json::array();
-    for (const auto& input : inputs) {
-        // Create a JSON request payload with the provided parameters
-        nlohmann::json request_payload = {
-            {"model", model_details_.model},
-            {"prompt", input},
-        };
-
-        nlohmann::json completion;
-        try {
-            completion = ollama_model_manager_uptr->CallEmbedding(request_payload);
-        } catch (const std::exception& e) {
-            throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
-        }
-
-        embeddings.push_back(completion["embedding"]);
+void OllamaProvider::CallCompleteStream(const std::string& prompt,
+                                        const std::function<void(nlohmann::json)>& on_tuple) {
+    auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret.at("api_url"), true);
+    ollama_model_manager_uptr->setRetryPolicy(model_details_.retry_policy);
+    ollama_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_),
+                                              Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
+
+    CompletionStream stream(CompletionStream::Format::NDJSON, on_tuple);
+    try {
+        ollama_model_manager_uptr->CallCompleteStream(
+            GetCompletionRequest(prompt, true, true),
+            [&stream](const char* data, const size_t size) { stream.Feed(data, size); });
+    } catch (const EndpointUnavailableError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
     }
-    return embeddings;
+
+    FinishCompletionStream(stream, "Ollama");
+}
+
+std::vector<std::vector<float>> OllamaProvider::CallEmbedding(const std::vector<std::string>& inputs) {
+    auto ollama_model_manager_uptr = std::make_unique<OllamaModelManager>(model_details_.secret.at("api_url"), true);
+    ollama_model_manager_uptr->setRetryPolicy(model_details_.retry_policy);
+    ollama_model_manager_uptr->setRateLimiter(RateLimiter::Get(model_details_), Tiktoken::GetNumTokens(inputs));
+
+    // Create a JSON request payload with the provided parameters
+    nlohmann::json request_payload = {
+        {"model", model_details_.model},
+        {"input", inputs},
+        {"keep_alive", -1},
+    };
+
+    EmbeddingParser parser;
+    try {
+        ollama_model_manager_uptr->CallEmbedding(request_payload, parser);
+    } catch (const EndpointUnavailableError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw std::runtime_error(duckdb_fmt::format("Error in making request to Ollama API: {}", e.what()));
+    }
+
+    return std::move(parser.embeddings);
 }
 
 } // namespace flockmtl
\ No newline at end of file
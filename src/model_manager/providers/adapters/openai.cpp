@@ -1,14 +1,19 @@
 #include "flockmtl/model_manager/providers/adapters/openai.hpp"
+#include "flockmtl/model_manager/tiktoken.hpp"
 
 namespace flockmtl {
 
-nlohmann::json OpenAIProvider::CallComplete(const std::string& prompt, bool json_response) {
+std::unique_ptr<openai::OpenAI> OpenAIProvider::CreateClient() {
     auto base_url = std::string("");
     if (const auto it = model_details_.secret.find("base_url"); it != model_details_.secret.end()) {
         base_url = it->second;
     }
-    auto openai = openai::OpenAI(model_details_.secret["api_key"], "", true, base_url);
+    auto openai = std::make_unique<openai::OpenAI>(model_details_.secret.at("api_key"), "", true, base_url);
+    openai->setRetryPolicy(model_details_.retry_policy);
+    return openai;
+}
 
+nlohmann::json OpenAIProvider::GetCompletionPayload(const std::string& prompt, const bool json_response) {
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {{"model", model_details_.model},
                                       {"messages", {{{"role", "user"}, {"content", prompt}}}},
@@ -20,70 +25,118 @@ nlohmann::json OpenAIProvider::CallComplete(const std::string& prompt, bool json
         request_payload["response_format"] = {{"type", "json_object"}};
     }
 
-    // Make a request to the OpenAI API
-    nlohmann::json completion;
+    return request_payload;
+}
+
+nlohmann::json OpenAIProvider::ParseCompletion(const nlohmann::json& completion, const bool json_response) {
+    CompletionResponse response;
+    if (const auto usage = completion.find("usage"); usage != completion.end()) {
+        response.prompt_tokens = usage->value("prompt_tokens", 0);
+        response.completion_tokens = usage->value("completion_tokens", 0);
+    }
+    const auto& choice = completion.at("choices").at(0);
+    const auto& message = choice.at("message");
+    auto read_string = [](const nlohmann::json& object, const char* key, std::string& value) {
+        if (const auto it = object.find(key); it != object.end() && it->is_string()) {
+            value = it->get<std::string>();
+        }
+    };
+    read_string(choice, "finish_reason", response.finish_reason);
+    read_string(message, "refusal", response.refusal);
+    read_string(message, "content", response.content);
+
+    return FinishCompletion(response, json_response, "OpenAI");
+}
+
+nlohmann::json OpenAIProvider::CallComplete(const std::string& prompt, bool json_response) {
+    auto openai = CreateClient();
+    openai->setRateLimiter(RateLimiter::Get(model_details_),
+                          Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
+
+    // Make a request to the OpenAI API, reading only the fields needed from the response
+    ChatCompletionParser parser;
     try {
-        completion = openai.chat.create(request_payload);
+        openai->chat.create(GetCompletionPayload(prompt, json_response), parser);
+    } catch (const EndpointUnavailableError&) {
+        throw;
     } catch (const std::exception& e) {
         throw std::runtime_error("Error in making request to OpenAI API: " + std::string(e.what()));
     }
-    // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
-        // Handle the error when the context window is too long
-        throw ExceededMaxOutputTokensError();
-    }
 
-    // Check if the OpenAI safety system refused the request
-    if (completion["choices"][0]["message"]["refusal"] != nullptr) {
-        // Handle refusal error
-        throw std::runtime_error(
-            duckdb_fmt::format("The request was refused due to OpenAI's safety system.{{\"refusal\": \"{}\"}}",
-                               completion["choices"][0]["message"]["refusal"].get<std::string>()));
-    }
+    return FinishCompletion(parser.response, json_response, "OpenAI");
+}
 
-    // Check if the model's output included restricted content
-    if (completion["choices"][0]["finish_reason"] == "content_filter") {
-        // Handle content filtering
-        throw std::runtime_error("The content filter was triggered, resulting in incomplete JSON.");
-    }
+void OpenAIProvider::CallCompleteStream(const std::string& prompt,
+                                        const std::function<void(nlohmann::json)>& on_tuple) {
+    auto openai = CreateClient();
+    openai->setRateLimiter(RateLimiter::Get(model_details_),
+                          Tiktoken::GetNumTokens(prompt) + model_details_.max_output_tokens);
 
-    std::string content_str = completion["choices"][0]["message"]["content"];
+    auto request_payload = GetCompletionPayload(prompt, true);
+    request_payload["stream"] = true;
+    // The usage is only reported, in a last chunk, when asked for
+    request_payload["stream_options"] = {{"include_usage", true}};
 
-    if (json_response) {
-        return nlohmann::json::parse(content_str);
+    CompletionStream stream(CompletionStream::Format::SERVER_SENT_EVENTS, on_tuple);
+    try {
+        openai->chat.createStream(request_payload,
+                                  [&stream](const char* data, const size_t size) { stream.Feed(data, size); });
+    } catch (const EndpointUnavailableError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error in making request to OpenAI API: " + std::string(e.what()));
     }
 
-    return content_str;
+    FinishCompletionStream(stream, "OpenAI");
 }
 
-nlohmann::json OpenAIProvider::CallEmbedding(const std::vector<std::string>& inputs) {
-    auto base_url = std::string("");
-    if (const auto it = model_details_.secret.find("base_url"); it != model_details_.secret.end()) {
-        base_url = it->second;
-    }
-    auto openai = openai::OpenAI(model_details_.secret["api_key"], "", true, base_url);
-
+nlohmann::json OpenAIProvider::GetEmbeddingPayload(const std::vector<std::string>& inputs) const {
     // Create a JSON request payload with the provided parameters
     nlohmann::json request_payload = {
         {"model", model_details_.model},
         {"input", inputs},
+        {"encoding_format", "base64"},
     };
+    if (model_details_.reduced_dimensions) {
+        request_payload["dimensions"] = model_details_.dimensions;
+    }
 
-    // Make a request to the OpenAI API
-    auto completion = openai.embedding.create(request_payload);
+    return request_payload;
+}
 
-    // Check if the conversation was too long for the context window
-    if (completion["choices"][0]["finish_reason"] == "length") {
-        // Handle the error when the context window is too long
-        throw ExceededMaxOutputTokensError();
-    }
+std::vector<std::vector<float>> OpenAIProvider::CallEmbedding(const std::vector<std::string>& inputs) {
+    auto openai = CreateClient();
+    openai->setRateLimiter(RateLimiter::Get(model_details_), Tiktoken::GetNumTokens(inputs));
+
+    // Make a request to the OpenAI API, decoding the embeddings as they are read
+    EmbeddingParser parser;
+    openai->embedding.create(GetEmbeddingPayload(inputs), parser);
+
+    return std::move(parser.embeddings);
+}
 
-    auto embeddings = nlohmann::json::array();
-    for (auto& item : completion["data"]) {
-        embeddings.push_back(item["embedding"]);
+std::string OpenAIProvider::SubmitBatch(const std::string& requests_file_path, const std::string& endpoint) {
+    std::string input_file_id;
+    {
+        auto openai = CreateClient();
+        auto file = openai->file.upload({{"file", requests_file_path}, {"purpose", "batch"}});
+        input_file_id = file["id"].get<std::string>();
     }
 
-    return embeddings;
+    auto openai = CreateClient();
+    auto batch = openai->batch.create(
+        {{"input_file_id", input_file_id}, {"endpoint", endpoint}, {"completion_window", "24h"}});
+    return batch["id"].get<std::string>();
+}
+
+nlohmann::json OpenAIProvider::RetrieveBatch(const std::string& batch_id) {
+    auto openai = CreateClient();
+    return openai->batch.retrieve(batch_id);
+}
+
+std::string OpenAIProvider::DownloadFile(const std::string& file_id) {
+    auto openai = CreateClient();
+    return openai->file.download(file_id);
 }
 
 } // namespace flockmtl
@@ -0,0 +1,148 @@
+#include "flockmtl/model_manager/rate_limiter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace flockmtl {
+
+std::mutex RateLimiter::registry_mutex_;
+std::map<std::string, std::shared_ptr<RateLimiter>> RateLimiter::registry_;
+
+RateLimiter::RateLimiter(const int32_t requests_per_minute, const int32_t tokens_per_minute)
+    : last_refill_(Clock::now()) {
+    requests_.Configure(requests_per_minute);
+    tokens_.Configure(tokens_per_minute);
+}
+
+std::string RateLimiter::GetKey(const ModelDetails& model_details) {
+    std::string endpoint;
+    for (const auto& field : {"base_url", "resource_name", "api_url"}) {
+        if (const auto it = model_details.secret.find(field); it != model_details.secret.end()) {
+            endpoint = it->second;
+        }
+    }
+    return model_details.provider_name + "/" + model_details.model + "/" + endpoint + "/" + model_details.secret_name;
+}
+
+std::shared_ptr<RateLimiter> RateLimiter::Get(const ModelDetails& model_details) {
+    // Quotas are granted per deployment and key, so requests to different endpoints never share a budget
+    const auto key = GetKey(model_details);
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto& limiter = registry_[key];
+    if (!limiter) {
+        limiter = std::make_shared<RateLimiter>(model_details.requests_per_minute, model_details.tokens_per_minute);
+    } else {
+        // The model may have been updated with other limits since the limiter was created
+        limiter->SetLimits(model_details.requests_per_minute, model_details.tokens_per_minute);
+    }
+    return limiter;
+}
+
+void RateLimiter::SetLimits(const int32_t requests_per_minute, const int32_t tokens_per_minute) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill();
+    requests_.Configure(requests_per_minute);
+    tokens_.Configure(tokens_per_minute);
+}
+
+void RateLimiter::Bucket::SetLimit(const double limit) {
+    // Keep the fraction of the budget already spent when the limit changes
+    available = capacity > 0 ? available * limit / capacity : limit;
+    capacity = limit;
+}
+
+void RateLimiter::Bucket::Configure(const int32_t limit) {
+    if (limit > 0) {
+        if (!configured || capacity != limit) {
+            SetLimit(limit);
+        }
+        configured = true;
+    } else if (configured) {
+        // Without a user limit, the budget is learned again from the headers of the next responses
+        capacity = 0;
+        available = 0;
+        configured = false;
+    }
+}
+
+void RateLimiter::Bucket::Refill(const double elapsed_ms) {
+    if (IsEnabled()) {
+        available = std::min(capacity, available + elapsed_ms * capacity / 60000.0);
+    }
+}
+
+double RateLimiter::Bucket::Reserve(double amount) {
+    if (!IsEnabled()) {
+        return 0;
+    }
+    // A request larger than the whole budget can only be paced, never fully covered
+    amount = std::min(amount, capacity);
+    available -= amount;
+    return available >= 0 ? 0 : -available * 60000.0 / capacity;
+}
+
+void RateLimiter::Refill() {
+    const auto now = Clock::now();
+    const auto elapsed_ms = std::chrono::duration<double, std::milli>(now - last_refill_).count();
+    last_refill_ = now;
+    requests_.Refill(elapsed_ms);
+    tokens_.Refill(elapsed_ms);
+}
+
+void RateLimiter::Acquire(const int64_t tokens) {
+    double wait_ms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Refill();
+        // Budgets are reserved up front, so concurrent callers queue up in arrival order
+        wait_ms = std::max(requests_.Reserve(1), tokens_.Reserve(static_cast<double>(tokens)));
+    }
+    if (wait_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(wait_ms));
+    }
+}
+
+void RateLimiter::Calibrate(const std::map<std::string, std::string>& headers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill();
+    for (auto [kind, bucket] : {std::make_pair("requests", &requests_), std::make_pair("tokens", &tokens_)}) {
+        if (const auto limit = headers.find(std::string("x-ratelimit-limit-") + kind);
+            limit != headers.end() && !bucket->configured) {
+            const auto learned_limit = std::atof(limit->second.c_str()) * learned_limit_ratio;
+            if (learned_limit > 0 && learned_limit != bucket->capacity) {
+                bucket->SetLimit(learned_limit);
+            }
+        }
+        if (const auto remaining = headers.find(std::string("x-ratelimit-remaining-") + kind);
+            remaining != headers.end() && bucket->IsEnabled()) {
+            // The provider knows about requests from other clients sharing the same quota
+            bucket->available = std::min(bucket->available, std::atof(remaining->second.c_str()));
+        }
+    }
+}
+
+double RateLimiter::GetHeadroom() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill();
+    auto headroom = 1.0;
+    for (const auto* bucket : {&requests_, &tokens_}) {
+        if (bucket->IsEnabled()) {
+            headroom = std::min(headroom, std::max(0.0, bucket->available / bucket->capacity));
+        }
+    }
+    return headroom;
+}
+
+void RateLimiter::Eject() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ejected_until_ = Clock::now() + std::chrono::milliseconds(ejection_ms);
+}
+
+bool RateLimiter::IsEjected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Clock::now() < ejected_until_;
+}
+
+} // namespace flockmtl
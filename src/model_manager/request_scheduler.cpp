@@ -0,0 +1,193 @@
+#include "flockmtl/model_manager/request_scheduler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include "flockmtl/model_manager/rate_limiter.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+thread_local RequestOrigin current_origin;
+thread_local RequestScheduler::Admission* current_admission = nullptr;
+
+RequestPriority ParsePriority(const std::string& value) {
+    auto priority = value;
+    std::transform(priority.begin(), priority.end(), priority.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (priority == "interactive") {
+        return RequestPriority::INTERACTIVE;
+    }
+    if (priority == "normal") {
+        return RequestPriority::NORMAL;
+    }
+    if (priority == "batch") {
+        return RequestPriority::BATCH;
+    }
+    throw std::invalid_argument(duckdb_fmt::format(
+        "Unsupported flockmtl_request_priority `{}`, expected `interactive`, `normal` or `batch`", value));
+}
+
+void SetRequestPriority(duckdb::ClientContext&, duckdb::SetScope, duckdb::Value& parameter) {
+    ParsePriority(parameter.ToString());
+}
+
+void SetMaxConcurrentRequests(duckdb::ClientContext&, const duckdb::SetScope scope, duckdb::Value& parameter) {
+    // The slots are shared by every connection of the process, so a session value would silently apply to all of them
+    if (scope != duckdb::SetScope::GLOBAL) {
+        throw std::invalid_argument(
+            "flockmtl_max_concurrent_requests is shared by all the connections, set it with SET GLOBAL");
+    }
+    const auto limit = parameter.GetValue<int64_t>();
+    if (limit < 0) {
+        throw std::invalid_argument(
+            duckdb_fmt::format("Invalid flockmtl_max_concurrent_requests `{}`, expected a positive number", limit));
+    }
+    RequestScheduler::Get().SetGlobalLimit(static_cast<size_t>(limit));
+}
+
+} // namespace
+
+RequestScheduler& RequestScheduler::Get() {
+    static RequestScheduler scheduler;
+    return scheduler;
+}
+
+RequestOrigin RequestScheduler::GetCurrentOrigin() { return current_origin; }
+
+void RequestScheduler::RegisterSettings(duckdb::DatabaseInstance& db) {
+    auto& config = duckdb::DBConfig::GetConfig(db);
+    config.AddExtensionOption("flockmtl_request_priority",
+                              "Scheduling class of the LLM requests of the connection: interactive, normal or batch",
+                              duckdb::LogicalType::VARCHAR, duckdb::Value("normal"), SetRequestPriority);
+    config.AddExtensionOption("flockmtl_max_concurrent_requests",
+                              "Maximum number of LLM requests in flight in the process, 0 for no limit",
+                              duckdb::LogicalType::BIGINT, duckdb::Value::BIGINT(default_max_concurrent_requests),
+                              SetMaxConcurrentRequests);
+}
+
+RequestOrigin RequestScheduler::GetOrigin(duckdb::ClientContext& context) {
+    RequestOrigin origin;
+    origin.query_id = context.transaction.GetActiveQuery();
+    duckdb::Value priority;
+    if (context.TryGetCurrentSetting("flockmtl_request_priority", priority) && !priority.IsNull()) {
+        origin.priority = ParsePriority(priority.ToString());
+    }
+    return origin;
+}
+
+RequestScheduler::OriginScope::OriginScope(duckdb::ClientContext& context) : previous_(current_origin) {
+    current_origin = GetOrigin(context);
+}
+
+RequestScheduler::OriginScope::~OriginScope() { current_origin = previous_; }
+
+RequestScheduler::Admission::Admission(const ModelDetails& model_details, const RequestOrigin& origin)
+    : model_details_(model_details), origin_(origin), previous_(current_admission) {
+    current_admission = this;
+}
+
+RequestScheduler::Admission::~Admission() { current_admission = previous_; }
+
+std::optional<RequestScheduler::Slot> RequestScheduler::AcquireForAttempt() {
+    if (!current_admission) {
+        return std::nullopt;
+    }
+    return Get().Acquire(current_admission->model_details_, current_admission->origin_);
+}
+
+RequestScheduler::Slot::~Slot() {
+    if (scheduler_) {
+        scheduler_->Release(model_key_, query_id_);
+    }
+}
+
+RequestScheduler::Slot RequestScheduler::Acquire(const ModelDetails& model_details, const RequestOrigin& origin) {
+    Waiter waiter;
+    waiter.origin = origin;
+    waiter.model_key = RateLimiter::GetKey(model_details);
+    waiter.model_limit =
+        model_details.max_concurrent_requests > 0 ? static_cast<size_t>(model_details.max_concurrent_requests) : 0;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& query = queries_[origin.query_id];
+    if (query.active == 0) {
+        // A query joining its class does not get credit for the time it was idle
+        query.virtual_time = std::max(query.virtual_time, class_time_[static_cast<int>(origin.priority)]);
+    }
+    query.active++;
+    waiter.sequence = next_sequence_++;
+    waiters_.push_back(&waiter);
+    Dispatch();
+    granted_.wait(lock, [&waiter] { return waiter.granted; });
+    return Slot(this, waiter.model_key, origin.query_id);
+}
+
+void RequestScheduler::SetGlobalLimit(const size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    global_limit_ = limit;
+    Dispatch();
+}
+
+void RequestScheduler::Dispatch() {
+    auto granted_any = false;
+    while (global_limit_ == 0 || in_flight_ < global_limit_) {
+        auto best = waiters_.end();
+        for (auto it = waiters_.begin(); it != waiters_.end(); ++it) {
+            const auto& waiter = **it;
+            if (waiter.model_limit > 0) {
+                const auto model_in_flight = model_in_flight_.find(waiter.model_key);
+                if (model_in_flight != model_in_flight_.end() && model_in_flight->second >= waiter.model_limit) {
+                    continue;
+                }
+            }
+            if (best == waiters_.end()) {
+                best = it;
+                continue;
+            }
+            // Strict priority between the classes, then the query granted the fewest requests, then arrival order
+            const auto& current = **best;
+            const auto rank = std::make_tuple(static_cast<int>(waiter.origin.priority),
+                                              queries_[waiter.origin.query_id].virtual_time, waiter.sequence);
+            const auto current_rank = std::make_tuple(static_cast<int>(current.origin.priority),
+                                                      queries_[current.origin.query_id].virtual_time, current.sequence);
+            if (rank < current_rank) {
+                best = it;
+            }
+        }
+        if (best == waiters_.end()) {
+            break;
+        }
+
+        auto& waiter = **best;
+        auto& query = queries_[waiter.origin.query_id];
+        auto& class_time = class_time_[static_cast<int>(waiter.origin.priority)];
+        class_time = std::max(class_time, query.virtual_time);
+        query.virtual_time++;
+        model_in_flight_[waiter.model_key]++;
+        in_flight_++;
+        waiter.granted = true;
+        waiters_.erase(best);
+        granted_any = true;
+    }
+    if (granted_any) {
+        granted_.notify_all();
+    }
+}
+
+void RequestScheduler::Release(const std::string& model_key, const uint64_t query_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_--;
+    if (const auto it = model_in_flight_.find(model_key); it != model_in_flight_.end() && --it->second == 0) {
+        model_in_flight_.erase(it);
+    }
+    if (const auto it = queries_.find(query_id); it != queries_.end() && --it->second.active == 0) {
+        queries_.erase(it);
+    }
+    Dispatch();
+}
+
+} // namespace flockmtl
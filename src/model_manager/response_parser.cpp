@@ -0,0 +1,178 @@
+#include "flockmtl/model_manager/response_parser.hpp"
+
+#include "flockmtl/model_manager/embedding_decoder.hpp"
+
+namespace flockmtl {
+
+bool ResponseParser::Parse(const std::string& body) {
+    path_.clear();
+    has_error_ = false;
+    return nlohmann::json::sax_parse(body, this);
+}
+
+void ResponseParser::EndValue() {
+    if (!path_.empty() && path_.back().is_array) {
+        path_.back().index++;
+    }
+}
+
+bool ResponseParser::null() {
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::boolean(const bool value) {
+    OnBoolean(value);
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::number_integer(const number_integer_t value) {
+    OnNumber(static_cast<double>(value));
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::number_unsigned(const number_unsigned_t value) {
+    OnNumber(static_cast<double>(value));
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::number_float(const number_float_t value, const string_t&) {
+    OnNumber(value);
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::string(string_t& value) {
+    OnString(value);
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::binary(binary_t&) {
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::start_object(std::size_t) {
+    path_.push_back({false, 0, {}});
+    return true;
+}
+
+bool ResponseParser::key(string_t& value) {
+    path_.back().key = value;
+    if (path_.size() == 1 && value == "error") {
+        has_error_ = true;
+    }
+    return true;
+}
+
+bool ResponseParser::end_object() {
+    path_.pop_back();
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::start_array(std::size_t) {
+    OnStartArray();
+    path_.push_back({true, 0, {}});
+    return true;
+}
+
+bool ResponseParser::end_array() {
+    path_.pop_back();
+    OnEndArray();
+    EndValue();
+    return true;
+}
+
+bool ResponseParser::parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) {
+    return false;
+}
+
+void ChatCompletionParser::OnString(std::string& value) {
+    if (!InFirstChoice()) {
+        return;
+    }
+    if (Depth() == 3 && KeyAt(2) == "finish_reason") {
+        response.finish_reason = std::move(value);
+    } else if (Depth() == 4 && KeyAt(2) == "message") {
+        if (KeyAt(3) == "content") {
+            response.content = std::move(value);
+        } else if (KeyAt(3) == "refusal") {
+            response.refusal = std::move(value);
+        }
+    }
+}
+
+void ChatCompletionParser::OnNumber(const double value) {
+    if (Depth() != 2 || KeyAt(0) != "usage") {
+        return;
+    }
+    if (KeyAt(1) == "prompt_tokens") {
+        response.prompt_tokens = static_cast<int32_t>(value);
+    } else if (KeyAt(1) == "completion_tokens") {
+        response.completion_tokens = static_cast<int32_t>(value);
+    }
+}
+
+void OllamaCompletionParser::OnString(std::string& value) {
+    if (Depth() != 1) {
+        return;
+    }
+    if (KeyAt(0) == "response") {
+        response.content = std::move(value);
+    } else if (KeyAt(0) == "done_reason") {
+        response.finish_reason = std::move(value);
+    }
+}
+
+void OllamaCompletionParser::OnNumber(const double value) {
+    if (Depth() != 1) {
+        return;
+    }
+    if (KeyAt(0) == "prompt_eval_count") {
+        response.prompt_tokens = static_cast<int32_t>(value);
+    } else if (KeyAt(0) == "eval_count") {
+        response.completion_tokens = static_cast<int32_t>(value);
+    }
+}
+
+void OllamaCompletionParser::OnBoolean(const bool value) {
+    if (Depth() == 1 && KeyAt(0) == "done") {
+        done = value;
+    }
+}
+
+bool EmbeddingParser::AtEmbedding() const {
+    return (Depth() == 3 && KeyAt(0) == "data" && KeyAt(2) == "embedding") ||
+           (Depth() == 2 && KeyAt(0) == "embeddings");
+}
+
+void EmbeddingParser::OnString(std::string& value) {
+    if (AtEmbedding()) {
+        embeddings.push_back(EmbeddingDecoder::DecodeBase64(value));
+    }
+}
+
+void EmbeddingParser::OnNumber(const double value) {
+    if (current_) {
+        current_->push_back(static_cast<float>(value));
+    }
+}
+
+void EmbeddingParser::OnStartArray() {
+    if (AtEmbedding()) {
+        current_ = &embeddings.emplace_back();
+    }
+}
+
+void EmbeddingParser::OnEndArray() {
+    if (current_ && AtEmbedding()) {
+        current_ = nullptr;
+    }
+}
+
+} // namespace flockmtl
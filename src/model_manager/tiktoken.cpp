@@ -1,14 +1,64 @@
-#include <regex>
-
 #include "flockmtl/model_manager/tiktoken.hpp"
 
 namespace flockmtl {
 
+namespace {
+
+bool IsWordCharacter(const unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool IsSpace(const unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool IsContinuationByte(const unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+} // namespace
+
+bool Tiktoken::NextToken(const std::string_view str, const size_t offset, size_t& begin, size_t& end) {
+    auto position = offset;
+    while (position < str.size() && IsSpace(str[position])) {
+        position++;
+    }
+    if (position >= str.size()) {
+        return false;
+    }
+
+    begin = position;
+    const auto c = static_cast<unsigned char>(str[position++]);
+    if (IsWordCharacter(c)) {
+        while (position < str.size() && IsWordCharacter(str[position])) {
+            position++;
+        }
+    } else if (c >= 0x80) {
+        while (position < str.size() && IsContinuationByte(str[position])) {
+            position++;
+        }
+    }
+    end = position;
+    return true;
+}
+
 int Tiktoken::GetNumTokens(const std::string& str) {
-    const std::regex word_regex(R"(\w+|[^\w\s])");
-    const auto words_begin = std::sregex_iterator(str.begin(), str.end(), word_regex);
-    const auto words_end = std::sregex_iterator();
-    return std::distance(words_begin, words_end);
+    // Counts as the `\w+|[^\w\s]` pattern did, which took every byte of a non-ASCII character as a token
+    auto num_tokens = 0;
+    size_t begin;
+    size_t end = 0;
+    while (NextToken(str, end, begin, end)) {
+        num_tokens += static_cast<unsigned char>(str[begin]) >= 0x80 ? static_cast<int>(end - begin) : 1;
+    }
+    return num_tokens;
+}
+
+int Tiktoken::GetNumTokens(const std::vector<std::string>& strs) {
+    auto num_tokens = 0;
+    for (const auto& str : strs) {
+        num_tokens += GetNumTokens(str);
+    }
+    return num_tokens;
 }
 
-} // namespace flockmtl
\ No newline at end of file
+} // namespace flockmtl
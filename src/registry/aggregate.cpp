@@ -7,6 +7,8 @@ void AggregateRegistry::Register(duckdb::DatabaseInstance& db) {
     RegisterLlmLast(db);
     RegisterLlmRerank(db);
     RegisterLlmReduce(db);
+    RegisterFusionStats(db);
+    RegisterVectorAggregates(db);
 }
 
 } // namespace flockmtl
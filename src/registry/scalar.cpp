@@ -7,7 +7,9 @@ void ScalarRegistry::Register(duckdb::DatabaseInstance& db) {
     RegisterLlmComplete(db);
     RegisterLlmEmbedding(db);
     RegisterLlmFilter(db);
-    RegisterFusionRelative(db);
+    RegisterFusion(db);
+    RegisterVectorSimilarity(db);
+    RegisterVectorQuantization(db);
 }
 
 } // namespace flockmtl
@@ -0,0 +1,16 @@
+#include "flockmtl/registry/table.hpp"
+
+namespace flockmtl {
+
+void TableRegistry::Register(duckdb::DatabaseInstance& db) {
+    RegisterChunkText(db);
+    RegisterHybridSearch(db);
+    RegisterLlmMap(db);
+    RegisterVectorIndex(db);
+    RegisterVectorKMeans(db);
+    RegisterVectorSearchExact(db);
+    RegisterVectorSearchRescore(db);
+    RegisterVectorSimilarityJoin(db);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,166 @@
+#include "flockmtl/vector/embedding_scanner.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "flockmtl/vector/float_vector.hpp"
+
+namespace flockmtl {
+
+std::string EmbeddingSource::GetQuotedTable() const {
+    const auto name = duckdb::QualifiedName::Parse(table_name);
+    std::string quoted;
+    for (const auto& part : {name.catalog, name.schema}) {
+        if (!part.empty()) {
+            quoted += duckdb::KeywordHelper::WriteOptionallyQuoted(part) + ".";
+        }
+    }
+    return quoted + duckdb::KeywordHelper::WriteOptionallyQuoted(name.name);
+}
+
+std::string EmbeddingSource::GetQuotedKey() const { return duckdb::KeywordHelper::WriteOptionallyQuoted(key_column); }
+
+std::string EmbeddingSource::GetQuotedEmbedding() const {
+    return duckdb::KeywordHelper::WriteOptionallyQuoted(embedding_column);
+}
+
+EmbeddingScanner::EmbeddingScanner(duckdb::Connection& con, const EmbeddingSource& source)
+    : embedding_column_(source.embedding_column) {
+    const auto filter = source.filter.empty() ? "true" : source.filter;
+    result_ = con.SendQuery(duckdb_fmt::format(" SELECT {}::BIGINT, {}::FLOAT[] "
+                                               "   FROM {} "
+                                               "  WHERE {} IS NOT NULL AND ({}); ",
+                                               source.GetQuotedKey(), source.GetQuotedEmbedding(),
+                                               source.GetQuotedTable(), source.GetQuotedEmbedding(), filter));
+    if (result_->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to read the embeddings of column '{}' of table '{}': {}",
+                                                    source.embedding_column, source.table_name,
+                                                    result_->GetError()));
+    }
+}
+
+bool EmbeddingScanner::Next(EmbeddingBlock& block, const size_t min_rows) {
+    block.keys.clear();
+    block.vectors.clear();
+    while (block.Size() < min_rows) {
+        const auto chunk = result_->Fetch();
+        if (!chunk || chunk->size() == 0) {
+            break;
+        }
+        auto& keys = chunk->data[0];
+        keys.Flatten(chunk->size());
+        const auto key_data = duckdb::FlatVector::GetData<int64_t>(keys);
+        const auto& key_validity = duckdb::FlatVector::Validity(keys);
+        const FloatVectorReader embeddings(chunk->data[1], chunk->size());
+
+        for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+            const float* embedding;
+            duckdb::idx_t size;
+            if (!key_validity.RowIsValid(row) || !embeddings.Get(row, embedding, size)) {
+                continue;
+            }
+            if (dimensions_ == 0) {
+                dimensions_ = size;
+            } else if (size != dimensions_) {
+                throw std::runtime_error(
+                    duckdb_fmt::format("Every embedding of column '{}' must have {} dimensions, but the row with key "
+                                       "{} has {}.",
+                                       embedding_column_, dimensions_, key_data[row], size));
+            }
+            block.keys.push_back(key_data[row]);
+            block.vectors.insert(block.vectors.end(), embedding, embedding + size);
+        }
+    }
+    block.dimensions = dimensions_;
+    return block.Size() != 0;
+}
+
+EmbeddingBlock EmbeddingScanner::ReadAll() {
+    EmbeddingBlock block;
+    Next(block, std::numeric_limits<size_t>::max());
+    return block;
+}
+
+void EmbeddingScanner::ScanParallel(const size_t num_threads, const size_t block_rows,
+                                    const std::function<void(size_t, EmbeddingBlock&)>& process) {
+    const auto num_workers = std::max<size_t>(num_threads, 1);
+    std::mutex mutex;
+    std::condition_variable block_ready;
+    std::condition_variable slot_ready;
+    std::deque<EmbeddingBlock> blocks;
+    auto finished = false;
+    std::exception_ptr error;
+
+    auto worker = [&](const size_t worker_id) {
+        while (true) {
+            EmbeddingBlock block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                block_ready.wait(lock, [&]() { return !blocks.empty() || finished; });
+                if (blocks.empty()) {
+                    return;
+                }
+                block = std::move(blocks.front());
+                blocks.pop_front();
+            }
+            slot_ready.notify_one();
+            try {
+                process(worker_id, block);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                finished = true;
+                blocks.clear();
+                slot_ready.notify_all();
+                block_ready.notify_all();
+                return;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_workers; i++) {
+        workers.emplace_back(worker, i);
+    }
+
+    // The scan itself is sequential, so the calling thread only reads while the workers process the blocks
+    try {
+        EmbeddingBlock block;
+        while (Next(block, block_rows)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Bounded, so slow workers do not buffer the whole table
+            slot_ready.wait(lock, [&]() { return blocks.size() < 2 * num_workers || finished; });
+            if (finished) {
+                break;
+            }
+            blocks.push_back(std::move(block));
+            block_ready.notify_one();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+        blocks.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    block_ready.notify_all();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace flockmtl
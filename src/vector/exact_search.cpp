@@ -0,0 +1,96 @@
+#include "flockmtl/vector/exact_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+ExactSearch::ExactSearch(const VectorMetric metric, std::vector<std::vector<float>> queries, const size_t k)
+    : metric_(metric), queries_(std::move(queries)), k_(k) {
+    query_norms_.reserve(queries_.size());
+    for (const auto& query : queries_) {
+        query_norms_.push_back(std::sqrt(VectorKernels::SquaredNorm(query.data(), query.size())));
+    }
+}
+
+void ExactSearch::Push(Heap& heap, const size_t k, const float distance, const int64_t key) {
+    if (heap.size() < k) {
+        heap.emplace_back(distance, key);
+        std::push_heap(heap.begin(), heap.end());
+    } else if (distance < heap.front().first) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = {distance, key};
+        std::push_heap(heap.begin(), heap.end());
+    }
+}
+
+void ExactSearch::ScoreBlock(const EmbeddingBlock& block, std::vector<Heap>& heaps) const {
+    const auto dimensions = block.dimensions;
+    float row_norms[tile_rows];
+    for (size_t tile = 0; tile < block.Size(); tile += tile_rows) {
+        const auto tile_end = std::min(tile + tile_rows, block.Size());
+        if (metric_ == VectorMetric::COSINE) {
+            for (auto row = tile; row < tile_end; row++) {
+                row_norms[row - tile] = std::sqrt(VectorKernels::SquaredNorm(block.GetVector(row), dimensions));
+            }
+        }
+
+        for (size_t query = 0; query < queries_.size(); query++) {
+            const auto* query_vector = queries_[query].data();
+            for (auto row = tile; row < tile_end; row++) {
+                const auto* vector = block.GetVector(row);
+                float distance;
+                switch (metric_) {
+                case VectorMetric::COSINE: {
+                    const auto norms = query_norms_[query] * row_norms[row - tile];
+                    distance =
+                        norms > 0 ? 1.0f - VectorKernels::InnerProduct(query_vector, vector, dimensions) / norms : 1.0f;
+                    break;
+                }
+                case VectorMetric::L2:
+                    distance = VectorKernels::L2SquaredDistance(query_vector, vector, dimensions);
+                    break;
+                default:
+                    distance = -VectorKernels::InnerProduct(query_vector, vector, dimensions);
+                    break;
+                }
+                Push(heaps[query], k_, distance, block.keys[row]);
+            }
+        }
+    }
+}
+
+std::vector<ExactSearch::Result> ExactSearch::Run(EmbeddingScanner& scanner, const size_t num_threads) {
+    const auto num_workers = std::max<size_t>(num_threads, 1);
+    std::vector<std::vector<Heap>> worker_heaps(num_workers, std::vector<Heap>(queries_.size()));
+    scanner.ScanParallel(num_workers, block_rows, [&](const size_t worker, EmbeddingBlock& block) {
+        for (const auto& query : queries_) {
+            if (query.size() != block.dimensions) {
+                throw std::runtime_error(duckdb_fmt::format(
+                    "The query vectors have {} dimensions, but the embeddings have {}.", query.size(),
+                    block.dimensions));
+            }
+        }
+        ScoreBlock(block, worker_heaps[worker]);
+    });
+
+    std::vector<Result> results(queries_.size());
+    for (size_t query = 0; query < queries_.size(); query++) {
+        Heap merged;
+        for (const auto& heaps : worker_heaps) {
+            for (const auto& [distance, key] : heaps[query]) {
+                Push(merged, k_, distance, key);
+            }
+        }
+        std::sort_heap(merged.begin(), merged.end());
+        results[query].reserve(merged.size());
+        for (const auto& [distance, key] : merged) {
+            results[query].emplace_back(key, metric_ == VectorMetric::L2 ? std::sqrt(distance) : distance);
+        }
+    }
+    return results;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,76 @@
+#include "flockmtl/vector/float_vector.hpp"
+
+#include <type_traits>
+
+namespace flockmtl {
+
+template <class T>
+VectorReader<T>::VectorReader(duckdb::Vector& vector, const duckdb::idx_t count)
+    : is_array_(vector.GetType().id() == duckdb::LogicalTypeId::ARRAY),
+      is_constant_(vector.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR) {
+    if (!is_constant_) {
+        vector.Flatten(count);
+    }
+    validity_ = is_constant_ ? &duckdb::ConstantVector::Validity(vector) : &duckdb::FlatVector::Validity(vector);
+
+    duckdb::idx_t child_size;
+    if (is_array_) {
+        array_size_ = duckdb::ArrayType::GetSize(vector.GetType());
+        child_size = (is_constant_ ? 1 : count) * array_size_;
+    } else {
+        list_entries_ = duckdb::ConstantVector::GetData<duckdb::list_entry_t>(vector);
+        child_size = duckdb::ListVector::GetListSize(vector);
+    }
+
+    auto& child = is_array_ ? duckdb::ArrayVector::GetEntry(vector) : duckdb::ListVector::GetEntry(vector);
+    child.Flatten(child_size);
+    child_data_ = duckdb::FlatVector::GetData<T>(child);
+    child_validity_ = &duckdb::FlatVector::Validity(child);
+}
+
+template <class T>
+bool VectorReader<T>::Get(const duckdb::idx_t row, const T*& data, duckdb::idx_t& size) const {
+    const auto index = is_constant_ ? 0 : row;
+    if (!validity_->RowIsValid(index)) {
+        return false;
+    }
+
+    duckdb::idx_t offset;
+    if (is_array_) {
+        offset = index * array_size_;
+        size = array_size_;
+    } else {
+        offset = list_entries_[index].offset;
+        size = list_entries_[index].length;
+    }
+    if (!child_validity_->AllValid()) {
+        for (duckdb::idx_t i = 0; i < size; i++) {
+            if (!child_validity_->RowIsValid(offset + i)) {
+                return false;
+            }
+        }
+    }
+
+    data = child_data_ + offset;
+    return true;
+}
+
+template <class T>
+duckdb::LogicalType VectorReader<T>::GetCastType(const duckdb::LogicalType& type, const std::string& function_name) {
+    const auto element_type = std::is_same<T, float>::value ? duckdb::LogicalType::FLOAT : duckdb::LogicalType::TINYINT;
+    switch (type.id()) {
+    case duckdb::LogicalTypeId::ARRAY:
+        return duckdb::LogicalType::ARRAY(element_type, duckdb::ArrayType::GetSize(type));
+    case duckdb::LogicalTypeId::LIST:
+    case duckdb::LogicalTypeId::SQLNULL:
+        return duckdb::LogicalType::LIST(element_type);
+    default:
+        throw std::runtime_error(duckdb_fmt::format("{}: Expected a {}[N] array or a numeric list, got {}.",
+                                                    function_name, element_type.ToString(), type.ToString()));
+    }
+}
+
+template class VectorReader<float>;
+template class VectorReader<int8_t>;
+
+} // namespace flockmtl
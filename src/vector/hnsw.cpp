@@ -0,0 +1,328 @@
+#include "flockmtl/vector/hnsw.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <queue>
+#include <thread>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+// Visited marks reused across the searches of a thread, reset by bumping the tag
+struct VisitedList {
+    std::vector<uint32_t> marks;
+    uint32_t tag = 0;
+
+    void Reset(const size_t size) {
+        if (marks.size() < size) {
+            marks.resize(size, 0);
+        }
+        if (++tag == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            tag = 1;
+        }
+    }
+    bool Visit(const uint32_t node) {
+        if (marks[node] == tag) {
+            return false;
+        }
+        marks[node] = tag;
+        return true;
+    }
+};
+
+thread_local VisitedList visited_list;
+
+uint64_t SplitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+HnswIndex::HnswIndex(const size_t dimensions, const VectorMetric metric, const size_t m, const size_t ef_construction)
+    : dimensions_(dimensions), metric_(metric), m_(std::max<size_t>(m, 2)),
+      ef_construction_(std::max(ef_construction, m_)), level_multiplier_(1.0 / std::log(static_cast<double>(m_))),
+      node_locks_(new std::mutex[lock_stripes]) {}
+
+void HnswIndex::Reserve(const size_t size) {
+    vectors_.reserve(size * dimensions_);
+    keys_.reserve(size);
+    links_.reserve(size);
+    deleted_.reserve(size);
+    versions_.reserve(size);
+}
+
+uint32_t HnswIndex::Append(const int64_t key, const float* vector) {
+    const auto node = static_cast<uint32_t>(keys_.size());
+    vectors_.resize(vectors_.size() + dimensions_);
+    keys_.push_back(key);
+    links_.emplace_back();
+    deleted_.push_back(0);
+    versions_.push_back(0);
+    SetVector(node, vector);
+    return node;
+}
+
+void HnswIndex::SetVector(const uint32_t node, const float* vector) {
+    auto* target = vectors_.data() + static_cast<size_t>(node) * dimensions_;
+    std::copy(vector, vector + dimensions_, target);
+    if (metric_ == VectorMetric::COSINE) {
+        const auto norm = std::sqrt(VectorKernels::SquaredNorm(vector, dimensions_));
+        if (norm > 0) {
+            for (size_t i = 0; i < dimensions_; i++) {
+                target[i] /= norm;
+            }
+        }
+    }
+}
+
+void HnswIndex::MarkDeleted(const uint32_t node) {
+    if (!deleted_[node]) {
+        deleted_[node] = 1;
+        deleted_count_++;
+    }
+}
+
+void HnswIndex::Restore(const uint32_t entry_point, const int max_level) {
+    entry_point_ = entry_point;
+    max_level_ = max_level;
+    linked_count_ = Size();
+}
+
+float HnswIndex::Distance(const float* a, const float* b) const {
+    switch (metric_) {
+    case VectorMetric::COSINE:
+        return 1.0f - VectorKernels::InnerProduct(a, b, dimensions_);
+    case VectorMetric::L2:
+        // Squared distances order the same way and spare a square root per comparison
+        return VectorKernels::L2SquaredDistance(a, b, dimensions_);
+    case VectorMetric::INNER_PRODUCT:
+        return -VectorKernels::InnerProduct(a, b, dimensions_);
+    }
+    return 0;
+}
+
+float HnswIndex::ToOutputDistance(const float distance) const {
+    return metric_ == VectorMetric::L2 ? std::sqrt(distance) : distance;
+}
+
+int HnswIndex::GetRandomLevel(const uint32_t node) const {
+    // Derived from the node id, so the level does not depend on the order in which threads insert the nodes
+    const auto uniform = (static_cast<double>(SplitMix64(node) >> 11) + 1.0) / 9007199254740993.0;
+    return static_cast<int>(-std::log(uniform) * level_multiplier_);
+}
+
+std::vector<uint32_t> HnswIndex::CopyLinks(const uint32_t node, const int level) const {
+    std::lock_guard<std::mutex> lock(GetNodeLock(node));
+    return links_[node][level];
+}
+
+uint32_t HnswIndex::SearchGreedy(const float* query, uint32_t entry_point, const int from_level,
+                                 const int to_level) const {
+    auto best_distance = Distance(query, GetVector(entry_point));
+    for (auto level = from_level; level > to_level; level--) {
+        auto changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto neighbor : CopyLinks(entry_point, level)) {
+                const auto distance = Distance(query, GetVector(neighbor));
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    entry_point = neighbor;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return entry_point;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::SearchLayer(const float* query, const uint32_t entry_point,
+                                                         const size_t ef, const int level) const {
+    auto& visited = visited_list;
+    visited.Reset(Size());
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    std::priority_queue<Candidate> results;
+    const auto entry_distance = Distance(query, GetVector(entry_point));
+    candidates.emplace(entry_distance, entry_point);
+    results.emplace(entry_distance, entry_point);
+    visited.Visit(entry_point);
+
+    while (!candidates.empty()) {
+        const auto [distance, node] = candidates.top();
+        if (results.size() >= ef && distance > results.top().first) {
+            break;
+        }
+        candidates.pop();
+
+        for (const auto neighbor : CopyLinks(node, level)) {
+            if (!visited.Visit(neighbor)) {
+                continue;
+            }
+            const auto neighbor_distance = Distance(query, GetVector(neighbor));
+            if (results.size() < ef || neighbor_distance < results.top().first) {
+                candidates.emplace(neighbor_distance, neighbor);
+                results.emplace(neighbor_distance, neighbor);
+                if (results.size() > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> closest(results.size());
+    for (auto i = closest.size(); i > 0; i--) {
+        closest[i - 1] = results.top();
+        results.pop();
+    }
+    return closest;
+}
+
+std::vector<uint32_t> HnswIndex::SelectNeighbors(std::vector<Candidate> candidates, const size_t max_links) const {
+    std::sort(candidates.begin(), candidates.end());
+
+    // A candidate closer to an already selected neighbor than to the base node is redundant; keeping the others
+    // spreads the links in every direction
+    std::vector<uint32_t> selected;
+    std::vector<uint32_t> pruned;
+    for (const auto& [distance, candidate] : candidates) {
+        if (selected.size() >= max_links) {
+            break;
+        }
+        auto diverse = true;
+        for (const auto neighbor : selected) {
+            if (Distance(GetVector(candidate), GetVector(neighbor)) < distance) {
+                diverse = false;
+                break;
+            }
+        }
+        (diverse ? selected : pruned).push_back(candidate);
+    }
+    for (size_t i = 0; i < pruned.size() && selected.size() < max_links; i++) {
+        selected.push_back(pruned[i]);
+    }
+    return selected;
+}
+
+void HnswIndex::Insert(const uint32_t node) {
+    const auto level = static_cast<int>(links_[node].size()) - 1;
+    const auto* vector = GetVector(node);
+
+    uint32_t entry_point;
+    int max_level;
+    {
+        std::lock_guard<std::mutex> lock(entry_mutex_);
+        if (max_level_ < 0) {
+            entry_point_ = node;
+            max_level_ = level;
+            return;
+        }
+        entry_point = entry_point_;
+        max_level = max_level_;
+    }
+
+    entry_point = SearchGreedy(vector, entry_point, max_level, level);
+    for (auto current_level = std::min(level, max_level); current_level >= 0; current_level--) {
+        auto candidates = SearchLayer(vector, entry_point, ef_construction_, current_level);
+        entry_point = candidates.front().second;
+        const auto neighbors = SelectNeighbors(candidates, GetMaxLinks(current_level));
+        {
+            std::lock_guard<std::mutex> lock(GetNodeLock(node));
+            links_[node][current_level] = neighbors;
+        }
+
+        for (const auto neighbor : neighbors) {
+            std::lock_guard<std::mutex> lock(GetNodeLock(neighbor));
+            auto& neighbor_links = links_[neighbor][current_level];
+            neighbor_links.push_back(node);
+            if (neighbor_links.size() > GetMaxLinks(current_level)) {
+                std::vector<Candidate> neighbor_candidates;
+                neighbor_candidates.reserve(neighbor_links.size());
+                for (const auto link : neighbor_links) {
+                    neighbor_candidates.emplace_back(Distance(GetVector(neighbor), GetVector(link)), link);
+                }
+                neighbor_links = SelectNeighbors(std::move(neighbor_candidates), GetMaxLinks(current_level));
+            }
+        }
+    }
+
+    if (level > max_level) {
+        std::lock_guard<std::mutex> lock(entry_mutex_);
+        if (level > max_level_) {
+            entry_point_ = node;
+            max_level_ = level;
+        }
+    }
+}
+
+void HnswIndex::Link(const size_t num_threads) {
+    const auto first_node = linked_count_;
+    const auto last_node = Size();
+    if (first_node == last_node) {
+        return;
+    }
+    // Levels are assigned upfront, so the link lists never move while other threads read them
+    for (auto node = first_node; node < last_node; node++) {
+        links_[node].resize(GetRandomLevel(static_cast<uint32_t>(node)) + 1);
+    }
+
+    std::atomic<size_t> next_node {first_node};
+    auto worker = [&]() {
+        for (auto node = next_node++; node < last_node; node = next_node++) {
+            Insert(static_cast<uint32_t>(node));
+        }
+    };
+    const auto num_workers = std::min(std::max<size_t>(num_threads, 1), last_node - first_node);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    linked_count_ = last_node;
+}
+
+std::vector<std::pair<int64_t, float>> HnswIndex::Search(const float* query, const size_t k,
+                                                         const size_t ef_search) const {
+    std::vector<std::pair<int64_t, float>> results;
+    if (max_level_ < 0 || k == 0) {
+        return results;
+    }
+
+    std::vector<float> normalized_query;
+    if (metric_ == VectorMetric::COSINE) {
+        normalized_query.assign(query, query + dimensions_);
+        const auto norm = std::sqrt(VectorKernels::SquaredNorm(query, dimensions_));
+        if (norm > 0) {
+            for (auto& value : normalized_query) {
+                value /= norm;
+            }
+        }
+        query = normalized_query.data();
+    }
+
+    // Deleted nodes are skipped in the output, so the search looks a bit further to still return k rows
+    const auto ef = std::max(ef_search, k) + std::min(GetDeletedCount(), k);
+    const auto entry_point = SearchGreedy(query, entry_point_, max_level_, 0);
+    for (const auto& [distance, node] : SearchLayer(query, entry_point, ef, 0)) {
+        if (results.size() == k) {
+            break;
+        }
+        if (!IsDeleted(node)) {
+            results.emplace_back(keys_[node], ToOutputDistance(distance));
+        }
+    }
+    return results;
+}
+
+} // namespace flockmtl
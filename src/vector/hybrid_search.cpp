@@ -0,0 +1,158 @@
+#include "flockmtl/vector/hybrid_search.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <unordered_map>
+
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "flockmtl/core/config.hpp"
+#include "flockmtl/functions/scalar/fusion.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+// Min-max normalized score of every candidate, from 1 for the best one to 0 for the worst. The candidates are sorted
+// best first, so this works for BM25 scores as well as for distances.
+std::vector<double> NormalizeScores(const ExactSearch::Result& candidates) {
+    std::vector<double> scores(candidates.size(), 1.0);
+    if (candidates.empty()) {
+        return scores;
+    }
+    const double best = candidates.front().second;
+    const double worst = candidates.back().second;
+    if (best != worst) {
+        for (size_t i = 0; i < candidates.size(); i++) {
+            scores[i] = (candidates[i].second - worst) / (best - worst);
+        }
+    }
+    return scores;
+}
+
+} // namespace
+
+HybridSearch::HybridSearch(HybridSearchOptions options, std::string query_text, std::vector<float> query_embedding)
+    : options_(options), query_text_(std::move(query_text)), query_embedding_(std::move(query_embedding)) {
+    options_.candidates = std::max(options_.candidates, options_.k);
+}
+
+HybridFusion HybridSearch::FusionFromString(const std::string& fusion) {
+    const auto name = duckdb::StringUtil::Lower(fusion);
+    if (name == "rrf") {
+        return HybridFusion::RRF;
+    }
+    if (name == "combsum") {
+        return HybridFusion::COMBSUM;
+    }
+    if (name == "combmnz") {
+        return HybridFusion::COMBMNZ;
+    }
+    throw std::runtime_error("Unsupported fusion '" + fusion + "', expected 'rrf', 'combsum' or 'combmnz'.");
+}
+
+ExactSearch::Result HybridSearch::SearchLexical(const EmbeddingSource& source, const std::string& text_column) const {
+    // ORDER BY ... LIMIT is planned as a top-N, which keeps a bounded heap instead of sorting every match
+    // create_fts_index keeps the index of a table in the schema fts_<schema>_<table>
+    const auto table = duckdb::QualifiedName::Parse(source.table_name);
+    const auto fts_schema = duckdb::KeywordHelper::WriteOptionallyQuoted(
+        duckdb_fmt::format("fts_{}_{}", table.schema.empty() ? "main" : table.schema, table.name));
+    auto con = Config::GetConnection();
+    auto statement = con.Prepare(duckdb_fmt::format(" SELECT {0}::BIGINT AS key, score "
+                                                    "   FROM (SELECT {0}, {1}.match_bm25({0}, $1, "
+                                                    "                                  fields := $2) AS score "
+                                                    "           FROM {2}) "
+                                                    "  WHERE score IS NOT NULL AND {0} IS NOT NULL "
+                                                    "  ORDER BY score DESC "
+                                                    "  LIMIT {3}; ",
+                                                    source.GetQuotedKey(), fts_schema, source.GetQuotedTable(),
+                                                    options_.candidates));
+    if (statement->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format(
+            "Failed to run the full-text search on table '{}', create its index with "
+            "PRAGMA create_fts_index('{}', '{}', '{}'): {}",
+            source.table_name, source.table_name, source.key_column, text_column, statement->GetError()));
+    }
+    auto result = statement->Execute(query_text_, text_column);
+    if (result->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to run the full-text search on table '{}': {}",
+                                                    source.table_name, result->GetError()));
+    }
+
+    ExactSearch::Result matches;
+    while (auto chunk = result->Fetch()) {
+        const auto keys = duckdb::FlatVector::GetData<int64_t>(chunk->data[0]);
+        const auto scores = duckdb::FlatVector::GetData<double>(chunk->data[1]);
+        for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+            matches.emplace_back(keys[row], static_cast<float>(scores[row]));
+        }
+    }
+    return matches;
+}
+
+std::vector<HybridMatch> HybridSearch::Fuse(const ExactSearch::Result& lexical,
+                                            const ExactSearch::Result& vector) const {
+    std::unordered_map<int64_t, HybridMatch> matches;
+    auto add_list = [&](const ExactSearch::Result& candidates, const bool is_lexical) {
+        const auto scores = NormalizeScores(candidates);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            auto [it, inserted] = matches.try_emplace(candidates[i].first, HybridMatch{candidates[i].first, 0, 0, 0});
+            auto& match = it->second;
+            const auto rank = static_cast<int32_t>(i + 1);
+            (is_lexical ? match.lexical_rank : match.vector_rank) = rank;
+            match.score += options_.fusion == HybridFusion::RRF ? 1.0 / (Fusion::rrf_k + rank) : scores[i];
+        }
+    };
+    add_list(lexical, true);
+    add_list(vector, false);
+
+    std::vector<HybridMatch> fused;
+    fused.reserve(matches.size());
+    for (auto& [key, match] : matches) {
+        if (options_.fusion == HybridFusion::COMBMNZ) {
+            match.score *= (match.lexical_rank > 0) + (match.vector_rank > 0);
+        }
+        fused.push_back(match);
+    }
+
+    const auto k = std::min(options_.k, fused.size());
+    const auto better = [](const HybridMatch& left, const HybridMatch& right) {
+        return left.score != right.score ? left.score > right.score : left.key < right.key;
+    };
+    std::partial_sort(fused.begin(), fused.begin() + k, fused.end(), better);
+    fused.resize(k);
+    return fused;
+}
+
+std::vector<HybridMatch> HybridSearch::Run(const EmbeddingSource& source, const std::string& text_column,
+                                           const size_t num_threads) const {
+    // The lexical search runs in its own connection while this thread drives the vector scan
+    ExactSearch::Result lexical;
+    std::exception_ptr lexical_error;
+    std::thread lexical_thread([&]() {
+        try {
+            lexical = SearchLexical(source, text_column);
+        } catch (...) {
+            lexical_error = std::current_exception();
+        }
+    });
+
+    ExactSearch::Result vector;
+    try {
+        auto con = Config::GetConnection();
+        EmbeddingScanner scanner(con, source);
+        ExactSearch search(options_.metric, {query_embedding_}, options_.candidates);
+        vector = search.Run(scanner, num_threads).front();
+    } catch (...) {
+        lexical_thread.join();
+        throw;
+    }
+    lexical_thread.join();
+    if (lexical_error) {
+        std::rethrow_exception(lexical_error);
+    }
+    return Fuse(lexical, vector);
+}
+
+} // namespace flockmtl
@@ -0,0 +1,679 @@
+#include "flockmtl/vector/kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLOCKMTL_VECTOR_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define FLOCKMTL_VECTOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace flockmtl {
+
+namespace {
+
+struct KernelTable {
+    float (*inner_product)(const float*, const float*, size_t);
+    float (*l2_squared_distance)(const float*, const float*, size_t);
+    float (*l1_distance)(const float*, const float*, size_t);
+    void (*inner_product_4)(const float*, const float*, size_t, float*);
+    int32_t (*int8_inner_product)(const int8_t*, const int8_t*, size_t);
+    uint64_t (*hamming_distance)(const uint8_t*, const uint8_t*, size_t);
+    void (*accumulate)(double*, const float*, float, size_t);
+    void (*add)(double*, const double*, size_t);
+    void (*minimum)(float*, const float*, size_t);
+    void (*maximum)(float*, const float*, size_t);
+    const char* instruction_set;
+};
+
+// The portable kernels keep several partial sums so the compiler can vectorize them without reassociating
+constexpr size_t portable_lanes = 8;
+
+float InnerProductPortable(const float* a, const float* b, const size_t size) {
+    float sums[portable_lanes] = {};
+    size_t i = 0;
+    for (; i + portable_lanes <= size; i += portable_lanes) {
+        for (size_t lane = 0; lane < portable_lanes; lane++) {
+            sums[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+    float result = 0;
+    for (const auto sum : sums) {
+        result += sum;
+    }
+    for (; i < size; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+float L2SquaredDistancePortable(const float* a, const float* b, const size_t size) {
+    float sums[portable_lanes] = {};
+    size_t i = 0;
+    for (; i + portable_lanes <= size; i += portable_lanes) {
+        for (size_t lane = 0; lane < portable_lanes; lane++) {
+            const auto diff = a[i + lane] - b[i + lane];
+            sums[lane] += diff * diff;
+        }
+    }
+    float result = 0;
+    for (const auto sum : sums) {
+        result += sum;
+    }
+    for (; i < size; i++) {
+        const auto diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+float L1DistancePortable(const float* a, const float* b, const size_t size) {
+    float sums[portable_lanes] = {};
+    size_t i = 0;
+    for (; i + portable_lanes <= size; i += portable_lanes) {
+        for (size_t lane = 0; lane < portable_lanes; lane++) {
+            sums[lane] += std::fabs(a[i + lane] - b[i + lane]);
+        }
+    }
+    float result = 0;
+    for (const auto sum : sums) {
+        result += sum;
+    }
+    for (; i < size; i++) {
+        result += std::fabs(a[i] - b[i]);
+    }
+    return result;
+}
+
+// Scores one vector against four consecutive rows of a matrix, loading each element of `a` once for all four
+void InnerProduct4Portable(const float* a, const float* b, const size_t size, float* out) {
+    for (size_t row = 0; row < 4; row++) {
+        out[row] = InnerProductPortable(a, b + row * size, size);
+    }
+}
+
+int32_t Int8InnerProductPortable(const int8_t* a, const int8_t* b, const size_t size) {
+    int32_t sums[portable_lanes] = {};
+    size_t i = 0;
+    for (; i + portable_lanes <= size; i += portable_lanes) {
+        for (size_t lane = 0; lane < portable_lanes; lane++) {
+            sums[lane] += static_cast<int32_t>(a[i + lane]) * b[i + lane];
+        }
+    }
+    int32_t result = 0;
+    for (const auto sum : sums) {
+        result += sum;
+    }
+    for (; i < size; i++) {
+        result += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return result;
+}
+
+// Loads whole 64-bit words, `memcpy` keeps them free of alignment requirements
+inline uint64_t LoadWord(const uint8_t* data) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(uint64_t));
+    return word;
+}
+
+uint64_t HammingDistancePortable(const uint8_t* a, const uint8_t* b, const size_t size) {
+    uint64_t result = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        result += __builtin_popcountll(LoadWord(a + i) ^ LoadWord(b + i));
+    }
+    for (; i < size; i++) {
+        result += __builtin_popcount(a[i] ^ b[i]);
+    }
+    return result;
+}
+
+void AccumulatePortable(double* sums, const float* a, const float scale, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        sums[i] += static_cast<double>(a[i] * scale);
+    }
+}
+
+void AddPortable(double* sums, const double* a, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        sums[i] += a[i];
+    }
+}
+
+void MinimumPortable(float* values, const float* a, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        values[i] = a[i] < values[i] ? a[i] : values[i];
+    }
+}
+
+void MaximumPortable(float* values, const float* a, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        values[i] = a[i] > values[i] ? a[i] : values[i];
+    }
+}
+
+#ifdef FLOCKMTL_VECTOR_X86
+
+__attribute__((target("avx2,fma"))) inline float HorizontalSumAvx2(const __m256 v) {
+    const auto sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const auto pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+}
+
+__attribute__((target("avx2,fma"))) float InnerProductAvx2(const float* a, const float* b, const size_t size) {
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= size; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+    auto result = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+    for (; i < size; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+__attribute__((target("avx2,fma"))) float L2SquaredDistanceAvx2(const float* a, const float* b, const size_t size) {
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto diff0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        const auto diff1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(diff0, diff0, sum0);
+        sum1 = _mm256_fmadd_ps(diff1, diff1, sum1);
+    }
+    for (; i + 8 <= size; i += 8) {
+        const auto diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(diff, diff, sum0);
+    }
+    auto result = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+    for (; i < size; i++) {
+        const auto diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+__attribute__((target("avx2,fma"))) float L1DistanceAvx2(const float* a, const float* b, const size_t size) {
+    const auto sign_mask = _mm256_set1_ps(-0.0f);
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto diff0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        const auto diff1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(sign_mask, diff0));
+        sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(sign_mask, diff1));
+    }
+    for (; i + 8 <= size; i += 8) {
+        const auto diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(sign_mask, diff));
+    }
+    auto result = HorizontalSumAvx2(_mm256_add_ps(sum0, sum1));
+    for (; i < size; i++) {
+        result += std::fabs(a[i] - b[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx2,fma"))) void InnerProduct4Avx2(const float* a, const float* b, const size_t size,
+                                                           float* out) {
+    const auto* b0 = b;
+    const auto* b1 = b + size;
+    const auto* b2 = b + 2 * size;
+    const auto* b3 = b + 3 * size;
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    auto sum2 = _mm256_setzero_ps();
+    auto sum3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const auto values = _mm256_loadu_ps(a + i);
+        sum0 = _mm256_fmadd_ps(values, _mm256_loadu_ps(b0 + i), sum0);
+        sum1 = _mm256_fmadd_ps(values, _mm256_loadu_ps(b1 + i), sum1);
+        sum2 = _mm256_fmadd_ps(values, _mm256_loadu_ps(b2 + i), sum2);
+        sum3 = _mm256_fmadd_ps(values, _mm256_loadu_ps(b3 + i), sum3);
+    }
+    out[0] = HorizontalSumAvx2(sum0);
+    out[1] = HorizontalSumAvx2(sum1);
+    out[2] = HorizontalSumAvx2(sum2);
+    out[3] = HorizontalSumAvx2(sum3);
+    for (; i < size; i++) {
+        out[0] += a[i] * b0[i];
+        out[1] += a[i] * b1[i];
+        out[2] += a[i] * b2[i];
+        out[3] += a[i] * b3[i];
+    }
+}
+
+__attribute__((target("avx2,fma"))) int32_t Int8InnerProductAvx2(const int8_t* a, const int8_t* b,
+                                                                 const size_t size) {
+    // Widened to 16 bits, so the pairwise sums of `madd` cannot overflow
+    auto sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto values_a = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const auto values_b = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(values_a, values_b));
+    }
+    const auto sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    const auto pairs = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0x4E));
+    auto result = _mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, 0xB1)));
+    for (; i < size; i++) {
+        result += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return result;
+}
+
+__attribute__((target("popcnt"))) uint64_t HammingDistancePopcnt(const uint8_t* a, const uint8_t* b,
+                                                                 const size_t size) {
+    uint64_t result = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        result += _mm_popcnt_u64(LoadWord(a + i) ^ LoadWord(b + i));
+    }
+    for (; i < size; i++) {
+        result += _mm_popcnt_u32(a[i] ^ b[i]);
+    }
+    return result;
+}
+
+// The element-wise kernels are memory bound, so the AVX2 versions are also used on AVX-512 CPUs
+__attribute__((target("avx2,fma"))) void AccumulateAvx2(double* sums, const float* a, const float scale,
+                                                        const size_t size) {
+    const auto scales = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const auto values = _mm256_mul_ps(_mm256_loadu_ps(a + i), scales);
+        const auto low = _mm256_cvtps_pd(_mm256_castps256_ps128(values));
+        const auto high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+        _mm256_storeu_pd(sums + i, _mm256_add_pd(_mm256_loadu_pd(sums + i), low));
+        _mm256_storeu_pd(sums + i + 4, _mm256_add_pd(_mm256_loadu_pd(sums + i + 4), high));
+    }
+    for (; i < size; i++) {
+        sums[i] += static_cast<double>(a[i] * scale);
+    }
+}
+
+__attribute__((target("avx2,fma"))) void AddAvx2(double* sums, const double* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(sums + i, _mm256_add_pd(_mm256_loadu_pd(sums + i), _mm256_loadu_pd(a + i)));
+    }
+    for (; i < size; i++) {
+        sums[i] += a[i];
+    }
+}
+
+__attribute__((target("avx2,fma"))) void MinimumAvx2(float* values, const float* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(values + i, _mm256_min_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(values + i)));
+    }
+    for (; i < size; i++) {
+        values[i] = a[i] < values[i] ? a[i] : values[i];
+    }
+}
+
+__attribute__((target("avx2,fma"))) void MaximumAvx2(float* values, const float* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(values + i, _mm256_max_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(values + i)));
+    }
+    for (; i < size; i++) {
+        values[i] = a[i] > values[i] ? a[i] : values[i];
+    }
+}
+
+// The AVX-512 kernels handle the tail with a masked load instead of a scalar loop
+__attribute__((target("avx512f"))) inline __mmask16 TailMaskAvx512(const size_t remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1u);
+}
+
+__attribute__((target("avx512f"))) float InnerProductAvx512(const float* a, const float* b, const size_t size) {
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), sum1);
+    }
+    for (; i + 16 <= size; i += 16) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    }
+    if (i < size) {
+        const auto mask = TailMaskAvx512(size - i);
+        sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), sum1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f"))) float L2SquaredDistanceAvx512(const float* a, const float* b, const size_t size) {
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const auto diff0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        const auto diff1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum0 = _mm512_fmadd_ps(diff0, diff0, sum0);
+        sum1 = _mm512_fmadd_ps(diff1, diff1, sum1);
+    }
+    for (; i + 16 <= size; i += 16) {
+        const auto diff = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum0 = _mm512_fmadd_ps(diff, diff, sum0);
+    }
+    if (i < size) {
+        const auto mask = TailMaskAvx512(size - i);
+        const auto diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum1 = _mm512_fmadd_ps(diff, diff, sum1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f"))) float L1DistanceAvx512(const float* a, const float* b, const size_t size) {
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i))));
+        sum1 = _mm512_add_ps(
+            sum1, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16))));
+    }
+    for (; i + 16 <= size; i += 16) {
+        sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i))));
+    }
+    if (i < size) {
+        const auto mask = TailMaskAvx512(size - i);
+        sum1 = _mm512_add_ps(sum1, _mm512_abs_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                                                               _mm512_maskz_loadu_ps(mask, b + i))));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f"))) void InnerProduct4Avx512(const float* a, const float* b, const size_t size,
+                                                            float* out) {
+    const auto* b0 = b;
+    const auto* b1 = b + size;
+    const auto* b2 = b + 2 * size;
+    const auto* b3 = b + 3 * size;
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    auto sum2 = _mm512_setzero_ps();
+    auto sum3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto values = _mm512_loadu_ps(a + i);
+        sum0 = _mm512_fmadd_ps(values, _mm512_loadu_ps(b0 + i), sum0);
+        sum1 = _mm512_fmadd_ps(values, _mm512_loadu_ps(b1 + i), sum1);
+        sum2 = _mm512_fmadd_ps(values, _mm512_loadu_ps(b2 + i), sum2);
+        sum3 = _mm512_fmadd_ps(values, _mm512_loadu_ps(b3 + i), sum3);
+    }
+    if (i < size) {
+        const auto mask = TailMaskAvx512(size - i);
+        const auto values = _mm512_maskz_loadu_ps(mask, a + i);
+        sum0 = _mm512_fmadd_ps(values, _mm512_maskz_loadu_ps(mask, b0 + i), sum0);
+        sum1 = _mm512_fmadd_ps(values, _mm512_maskz_loadu_ps(mask, b1 + i), sum1);
+        sum2 = _mm512_fmadd_ps(values, _mm512_maskz_loadu_ps(mask, b2 + i), sum2);
+        sum3 = _mm512_fmadd_ps(values, _mm512_maskz_loadu_ps(mask, b3 + i), sum3);
+    }
+    out[0] = _mm512_reduce_add_ps(sum0);
+    out[1] = _mm512_reduce_add_ps(sum1);
+    out[2] = _mm512_reduce_add_ps(sum2);
+    out[3] = _mm512_reduce_add_ps(sum3);
+}
+
+#endif
+
+#ifdef FLOCKMTL_VECTOR_NEON
+
+float InnerProductNeon(const float* a, const float* b, const size_t size) {
+    auto sum0 = vdupq_n_f32(0);
+    auto sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    for (; i + 4 <= size; i += 4) {
+        sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    auto result = vaddvq_f32(vaddq_f32(sum0, sum1));
+    for (; i < size; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+float L2SquaredDistanceNeon(const float* a, const float* b, const size_t size) {
+    auto sum0 = vdupq_n_f32(0);
+    auto sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const auto diff0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        const auto diff1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        sum0 = vfmaq_f32(sum0, diff0, diff0);
+        sum1 = vfmaq_f32(sum1, diff1, diff1);
+    }
+    for (; i + 4 <= size; i += 4) {
+        const auto diff = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        sum0 = vfmaq_f32(sum0, diff, diff);
+    }
+    auto result = vaddvq_f32(vaddq_f32(sum0, sum1));
+    for (; i < size; i++) {
+        const auto diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+float L1DistanceNeon(const float* a, const float* b, const size_t size) {
+    auto sum0 = vdupq_n_f32(0);
+    auto sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        sum0 = vaddq_f32(sum0, vabdq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        sum1 = vaddq_f32(sum1, vabdq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    }
+    for (; i + 4 <= size; i += 4) {
+        sum0 = vaddq_f32(sum0, vabdq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+    auto result = vaddvq_f32(vaddq_f32(sum0, sum1));
+    for (; i < size; i++) {
+        result += std::fabs(a[i] - b[i]);
+    }
+    return result;
+}
+
+void InnerProduct4Neon(const float* a, const float* b, const size_t size, float* out) {
+    const auto* b0 = b;
+    const auto* b1 = b + size;
+    const auto* b2 = b + 2 * size;
+    const auto* b3 = b + 3 * size;
+    auto sum0 = vdupq_n_f32(0);
+    auto sum1 = vdupq_n_f32(0);
+    auto sum2 = vdupq_n_f32(0);
+    auto sum3 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const auto values = vld1q_f32(a + i);
+        sum0 = vfmaq_f32(sum0, values, vld1q_f32(b0 + i));
+        sum1 = vfmaq_f32(sum1, values, vld1q_f32(b1 + i));
+        sum2 = vfmaq_f32(sum2, values, vld1q_f32(b2 + i));
+        sum3 = vfmaq_f32(sum3, values, vld1q_f32(b3 + i));
+    }
+    out[0] = vaddvq_f32(sum0);
+    out[1] = vaddvq_f32(sum1);
+    out[2] = vaddvq_f32(sum2);
+    out[3] = vaddvq_f32(sum3);
+    for (; i < size; i++) {
+        out[0] += a[i] * b0[i];
+        out[1] += a[i] * b1[i];
+        out[2] += a[i] * b2[i];
+        out[3] += a[i] * b3[i];
+    }
+}
+
+int32_t Int8InnerProductNeon(const int8_t* a, const int8_t* b, const size_t size) {
+    auto sum = vdupq_n_s32(0);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto values_a = vld1q_s8(a + i);
+        const auto values_b = vld1q_s8(b + i);
+        sum = vpadalq_s16(sum, vmull_s8(vget_low_s8(values_a), vget_low_s8(values_b)));
+        sum = vpadalq_s16(sum, vmull_s8(vget_high_s8(values_a), vget_high_s8(values_b)));
+    }
+    auto result = vaddvq_s32(sum);
+    for (; i < size; i++) {
+        result += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return result;
+}
+
+uint64_t HammingDistanceNeon(const uint8_t* a, const uint8_t* b, const size_t size) {
+    uint64_t result = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        result += vaddvq_u8(vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i))));
+    }
+    for (; i < size; i++) {
+        result += __builtin_popcount(a[i] ^ b[i]);
+    }
+    return result;
+}
+
+void AccumulateNeon(double* sums, const float* a, const float scale, const size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const auto values = vmulq_n_f32(vld1q_f32(a + i), scale);
+        vst1q_f64(sums + i, vaddq_f64(vld1q_f64(sums + i), vcvt_f64_f32(vget_low_f32(values))));
+        vst1q_f64(sums + i + 2, vaddq_f64(vld1q_f64(sums + i + 2), vcvt_high_f64_f32(values)));
+    }
+    for (; i < size; i++) {
+        sums[i] += static_cast<double>(a[i] * scale);
+    }
+}
+
+void AddNeon(double* sums, const double* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        vst1q_f64(sums + i, vaddq_f64(vld1q_f64(sums + i), vld1q_f64(a + i)));
+    }
+    for (; i < size; i++) {
+        sums[i] += a[i];
+    }
+}
+
+void MinimumNeon(float* values, const float* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        vst1q_f32(values + i, vminq_f32(vld1q_f32(a + i), vld1q_f32(values + i)));
+    }
+    for (; i < size; i++) {
+        values[i] = a[i] < values[i] ? a[i] : values[i];
+    }
+}
+
+void MaximumNeon(float* values, const float* a, const size_t size) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        vst1q_f32(values + i, vmaxq_f32(vld1q_f32(a + i), vld1q_f32(values + i)));
+    }
+    for (; i < size; i++) {
+        values[i] = a[i] > values[i] ? a[i] : values[i];
+    }
+}
+
+#endif
+
+KernelTable SelectKernels() {
+#ifdef FLOCKMTL_VECTOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {InnerProductAvx512, L2SquaredDistanceAvx512, L1DistanceAvx512, InnerProduct4Avx512,
+                Int8InnerProductAvx2, HammingDistancePopcnt, AccumulateAvx2, AddAvx2, MinimumAvx2, MaximumAvx2,
+                "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {InnerProductAvx2, L2SquaredDistanceAvx2, L1DistanceAvx2, InnerProduct4Avx2, Int8InnerProductAvx2,
+                HammingDistancePopcnt, AccumulateAvx2, AddAvx2, MinimumAvx2, MaximumAvx2, "avx2"};
+    }
+#endif
+#ifdef FLOCKMTL_VECTOR_NEON
+    return {InnerProductNeon, L2SquaredDistanceNeon, L1DistanceNeon, InnerProduct4Neon, Int8InnerProductNeon,
+            HammingDistanceNeon, AccumulateNeon, AddNeon, MinimumNeon, MaximumNeon, "neon"};
+#else
+    return {InnerProductPortable, L2SquaredDistancePortable, L1DistancePortable, InnerProduct4Portable,
+            Int8InnerProductPortable, HammingDistancePortable, AccumulatePortable, AddPortable, MinimumPortable,
+            MaximumPortable, "portable"};
+#endif
+}
+
+const KernelTable& GetKernels() {
+    static const KernelTable kernels = SelectKernels();
+    return kernels;
+}
+
+} // namespace
+
+float VectorKernels::InnerProduct(const float* a, const float* b, const size_t size) {
+    return GetKernels().inner_product(a, b, size);
+}
+
+float VectorKernels::SquaredNorm(const float* a, const size_t size) { return GetKernels().inner_product(a, a, size); }
+
+float VectorKernels::L2SquaredDistance(const float* a, const float* b, const size_t size) {
+    return GetKernels().l2_squared_distance(a, b, size);
+}
+
+float VectorKernels::L1Distance(const float* a, const float* b, const size_t size) {
+    return GetKernels().l1_distance(a, b, size);
+}
+
+void VectorKernels::InnerProducts(const float* a, const float* b, const size_t rows, const size_t size, float* out) {
+    const auto& kernels = GetKernels();
+    size_t row = 0;
+    for (; row + 4 <= rows; row += 4) {
+        kernels.inner_product_4(a, b + row * size, size, out + row);
+    }
+    for (; row < rows; row++) {
+        out[row] = kernels.inner_product(a, b + row * size, size);
+    }
+}
+
+int32_t VectorKernels::Int8InnerProduct(const int8_t* a, const int8_t* b, const size_t size) {
+    return GetKernels().int8_inner_product(a, b, size);
+}
+
+uint64_t VectorKernels::HammingDistance(const uint8_t* a, const uint8_t* b, const size_t size) {
+    return GetKernels().hamming_distance(a, b, size);
+}
+
+void VectorKernels::Accumulate(double* sums, const float* a, const float scale, const size_t size) {
+    GetKernels().accumulate(sums, a, scale, size);
+}
+
+void VectorKernels::Add(double* sums, const double* a, const size_t size) {
+    GetKernels().add(sums, a, size);
+}
+
+void VectorKernels::Minimum(float* values, const float* a, const size_t size) {
+    GetKernels().minimum(values, a, size);
+}
+
+void VectorKernels::Maximum(float* values, const float* a, const size_t size) {
+    GetKernels().maximum(values, a, size);
+}
+
+const char* VectorKernels::GetInstructionSet() { return GetKernels().instruction_set; }
+
+} // namespace flockmtl
@@ -0,0 +1,347 @@
+#include "flockmtl/vector/kmeans.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+KMeans::KMeans(KMeansOptions options) : options_(options) {
+    if (options_.metric == VectorMetric::INNER_PRODUCT) {
+        throw std::runtime_error("K-means only supports the 'l2' and 'cosine' metrics.");
+    }
+}
+
+void KMeans::ParallelFor(const size_t count, const size_t num_threads,
+                         const std::function<void(size_t, size_t, size_t)>& process) {
+    const auto num_blocks = (count + block_rows - 1) / block_rows;
+    if (num_blocks == 0) {
+        return;
+    }
+    std::atomic<size_t> next_block {0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto worker = [&](const size_t worker_id) {
+        try {
+            for (auto block = next_block++; block < num_blocks; block = next_block++) {
+                process(worker_id, block * block_rows, std::min(count, (block + 1) * block_rows));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    const auto num_workers = std::min(std::max<size_t>(num_threads, 1), num_blocks);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; i++) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void KMeans::Normalize(float* vector, const size_t size) const {
+    const auto norm = std::sqrt(VectorKernels::SquaredNorm(vector, size));
+    if (norm > 0) {
+        for (size_t i = 0; i < size; i++) {
+            vector[i] /= norm;
+        }
+    }
+}
+
+float KMeans::ToOutputDistance(const float distance) const {
+    return options_.metric == VectorMetric::L2 ? std::sqrt(distance) : distance;
+}
+
+std::pair<uint32_t, float> KMeans::FindClosest(const float* row, const float row_squared_norm,
+                                               const std::vector<float>& centroids,
+                                               const std::vector<float>& centroid_squared_norms, float* scores) const {
+    const auto dimensions = centroids.size() / options_.k;
+    VectorKernels::InnerProducts(row, centroids.data(), options_.k, dimensions, scores);
+
+    // Both sides are unit length with the cosine metric, otherwise |x - c|^2 = |x|^2 + |c|^2 - 2 x.c
+    uint32_t best = 0;
+    auto best_distance = std::numeric_limits<float>::max();
+    for (size_t centroid = 0; centroid < options_.k; centroid++) {
+        const auto distance = options_.metric == VectorMetric::COSINE
+                                  ? 1.0f - scores[centroid]
+                                  : row_squared_norm + centroid_squared_norms[centroid] - 2.0f * scores[centroid];
+        if (distance < best_distance) {
+            best = static_cast<uint32_t>(centroid);
+            best_distance = distance;
+        }
+    }
+    return {best, std::max(best_distance, 0.0f)};
+}
+
+void KMeans::Assign(const EmbeddingBlock& data, const std::vector<float>& row_squared_norms,
+                    const std::vector<float>& centroids, std::vector<uint32_t>& assignments,
+                    std::vector<float>& distances, const size_t num_threads, const std::vector<size_t>& rows) const {
+    std::vector<float> centroid_squared_norms(options_.k);
+    for (size_t centroid = 0; centroid < options_.k; centroid++) {
+        centroid_squared_norms[centroid] =
+            VectorKernels::SquaredNorm(centroids.data() + centroid * data.dimensions, data.dimensions);
+    }
+    const auto count = rows.empty() ? data.Size() : rows.size();
+    ParallelFor(count, num_threads, [&](size_t, const size_t begin, const size_t end) {
+        std::vector<float> scores(options_.k);
+        for (auto i = begin; i < end; i++) {
+            const auto row = rows.empty() ? i : rows[i];
+            std::tie(assignments[i], distances[i]) = FindClosest(data.GetVector(row), row_squared_norms[row],
+                                                                 centroids, centroid_squared_norms, scores.data());
+        }
+    });
+}
+
+float KMeans::SeedingDistance(const float* row, const float* centroid, const size_t dimensions) const {
+    return options_.metric == VectorMetric::COSINE
+               ? std::max(0.0f, 1.0f - VectorKernels::InnerProduct(row, centroid, dimensions))
+               : VectorKernels::L2SquaredDistance(row, centroid, dimensions);
+}
+
+void KMeans::InitializeCentroids(const EmbeddingBlock& data, const std::vector<size_t>& candidates,
+                                 std::vector<float>& centroids, std::mt19937_64& random,
+                                 const size_t num_threads) const {
+    const auto dimensions = data.dimensions;
+    const auto num_workers = std::max<size_t>(num_threads, 1);
+    // Greedy k-means++: several rows are drawn per step and the one reducing the potential the most is kept, which
+    // avoids seeding two centroids in the same cluster
+    const auto num_trials = 2 + static_cast<size_t>(std::log(static_cast<double>(options_.k)));
+    std::vector<float> min_distances(candidates.size(), std::numeric_limits<float>::max());
+    std::vector<size_t> trials;
+    std::vector<std::vector<double>> worker_potentials(num_workers);
+
+    for (size_t centroid = 0; centroid < options_.k; centroid++) {
+        trials.clear();
+        const auto total = centroid == 0 ? 0.0 : std::accumulate(min_distances.begin(), min_distances.end(), 0.0);
+        if (total > 0) {
+            // Rows are drawn with a probability proportional to their distance to the closest centroid
+            for (size_t trial = 0; trial < num_trials; trial++) {
+                auto target = std::uniform_real_distribution<double>(0, total)(random);
+                size_t i = 0;
+                for (; i + 1 < candidates.size(); i++) {
+                    target -= min_distances[i];
+                    if (target <= 0) {
+                        break;
+                    }
+                }
+                trials.push_back(candidates[i]);
+            }
+        } else {
+            // First centroid, or every candidate is already a centroid
+            trials.push_back(candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(random)]);
+        }
+
+        auto chosen = trials.front();
+        if (trials.size() > 1) {
+            for (auto& potentials : worker_potentials) {
+                potentials.assign(trials.size(), 0);
+            }
+            ParallelFor(candidates.size(), num_workers, [&](const size_t worker, const size_t begin, const size_t end) {
+                auto& potentials = worker_potentials[worker];
+                for (auto i = begin; i < end; i++) {
+                    const auto* row = data.GetVector(candidates[i]);
+                    for (size_t trial = 0; trial < trials.size(); trial++) {
+                        potentials[trial] +=
+                            std::min(min_distances[i], SeedingDistance(row, data.GetVector(trials[trial]), dimensions));
+                    }
+                }
+            });
+            auto best_potential = std::numeric_limits<double>::max();
+            for (size_t trial = 0; trial < trials.size(); trial++) {
+                double potential = 0;
+                for (const auto& potentials : worker_potentials) {
+                    potential += potentials[trial];
+                }
+                if (potential < best_potential) {
+                    best_potential = potential;
+                    chosen = trials[trial];
+                }
+            }
+        }
+
+        auto* centroid_vector = centroids.data() + centroid * dimensions;
+        std::copy_n(data.GetVector(chosen), dimensions, centroid_vector);
+        ParallelFor(candidates.size(), num_workers, [&](size_t, const size_t begin, const size_t end) {
+            for (auto i = begin; i < end; i++) {
+                min_distances[i] =
+                    std::min(min_distances[i], SeedingDistance(data.GetVector(candidates[i]), centroid_vector,
+                                                               dimensions));
+            }
+        });
+    }
+}
+
+KMeansResult KMeans::Run(EmbeddingBlock& data, const size_t num_threads) const {
+    const auto num_rows = data.Size();
+    const auto dimensions = data.dimensions;
+    const auto k = options_.k;
+    if (num_rows < k) {
+        throw std::runtime_error(duckdb_fmt::format("Cannot form {} clusters from {} rows.", k, num_rows));
+    }
+    std::mt19937_64 random(options_.seed);
+
+    // Spherical k-means works on unit vectors, so the cosine distance is a plain inner product
+    std::vector<float> row_squared_norms(num_rows);
+    ParallelFor(num_rows, num_threads, [&](size_t, const size_t begin, const size_t end) {
+        for (auto row = begin; row < end; row++) {
+            auto* vector = data.vectors.data() + row * dimensions;
+            if (options_.metric == VectorMetric::COSINE) {
+                Normalize(vector, dimensions);
+            }
+            row_squared_norms[row] = VectorKernels::SquaredNorm(vector, dimensions);
+        }
+    });
+
+    // Mini-batch k-means is seeded from a sample, so that it never needs a full pass over the rows per centroid
+    std::vector<size_t> candidates(num_rows);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    if (options_.batch_size > 0) {
+        const auto sample_size = std::min(num_rows, std::max(3 * options_.batch_size, k));
+        for (size_t i = 0; i < sample_size; i++) {
+            std::swap(candidates[i], candidates[std::uniform_int_distribution<size_t>(i, num_rows - 1)(random)]);
+        }
+        candidates.resize(sample_size);
+    }
+
+    KMeansResult result;
+    result.dimensions = dimensions;
+    result.centroids.resize(k * dimensions);
+    InitializeCentroids(data, candidates, result.centroids, random, num_threads);
+    candidates.clear();
+    candidates.shrink_to_fit();
+
+    result.assignments.assign(num_rows, std::numeric_limits<uint32_t>::max());
+    result.distances.resize(num_rows);
+    auto converged = false;
+
+    if (options_.batch_size == 0) {
+        const auto num_workers = std::max<size_t>(num_threads, 1);
+        std::vector<std::vector<double>> worker_sums(num_workers);
+        std::vector<std::vector<int64_t>> worker_counts(num_workers);
+        std::vector<float> centroid_squared_norms(k);
+
+        while (result.iterations < options_.max_iterations) {
+            result.iterations++;
+            for (size_t centroid = 0; centroid < k; centroid++) {
+                centroid_squared_norms[centroid] =
+                    VectorKernels::SquaredNorm(result.centroids.data() + centroid * dimensions, dimensions);
+            }
+            for (size_t worker = 0; worker < num_workers; worker++) {
+                worker_sums[worker].assign(k * dimensions, 0);
+                worker_counts[worker].assign(k, 0);
+            }
+            std::atomic<size_t> changed {0};
+            ParallelFor(num_rows, num_workers, [&](const size_t worker, const size_t begin, const size_t end) {
+                std::vector<float> scores(k);
+                auto& sums = worker_sums[worker];
+                auto& counts = worker_counts[worker];
+                size_t worker_changed = 0;
+                for (auto row = begin; row < end; row++) {
+                    const auto* vector = data.GetVector(row);
+                    const auto [centroid, distance] = FindClosest(vector, row_squared_norms[row], result.centroids,
+                                                                  centroid_squared_norms, scores.data());
+                    worker_changed += result.assignments[row] != centroid;
+                    result.assignments[row] = centroid;
+                    result.distances[row] = distance;
+                    counts[centroid]++;
+                    auto* sum = sums.data() + centroid * dimensions;
+                    for (size_t i = 0; i < dimensions; i++) {
+                        sum[i] += vector[i];
+                    }
+                }
+                changed += worker_changed;
+            });
+            // Unchanged assignments give back the same centroids
+            if (changed == 0) {
+                converged = true;
+                break;
+            }
+
+            for (size_t worker = 1; worker < num_workers; worker++) {
+                for (size_t i = 0; i < k * dimensions; i++) {
+                    worker_sums[0][i] += worker_sums[worker][i];
+                }
+                for (size_t centroid = 0; centroid < k; centroid++) {
+                    worker_counts[0][centroid] += worker_counts[worker][centroid];
+                }
+            }
+            for (size_t centroid = 0; centroid < k; centroid++) {
+                auto* centroid_vector = result.centroids.data() + centroid * dimensions;
+                const auto count = worker_counts[0][centroid];
+                if (count == 0) {
+                    // An empty cluster restarts from the row farthest from its centroid
+                    const auto farthest = static_cast<size_t>(
+                        std::max_element(result.distances.begin(), result.distances.end()) - result.distances.begin());
+                    std::copy_n(data.GetVector(farthest), dimensions, centroid_vector);
+                    result.distances[farthest] = 0;
+                    continue;
+                }
+                const auto* sum = worker_sums[0].data() + centroid * dimensions;
+                for (size_t i = 0; i < dimensions; i++) {
+                    centroid_vector[i] = static_cast<float>(sum[i] / static_cast<double>(count));
+                }
+                if (options_.metric == VectorMetric::COSINE) {
+                    Normalize(centroid_vector, dimensions);
+                }
+            }
+        }
+    } else {
+        // Each batch moves the centroids towards its rows, with a learning rate decreasing as a centroid sees more rows
+        const auto batch_size = std::min(options_.batch_size, num_rows);
+        std::vector<size_t> batch(batch_size);
+        std::vector<uint32_t> batch_assignments(batch_size);
+        std::vector<float> batch_distances(batch_size);
+        std::vector<int64_t> seen(k, 0);
+        std::uniform_int_distribution<size_t> pick_row(0, num_rows - 1);
+
+        while (result.iterations < options_.max_iterations) {
+            result.iterations++;
+            for (auto& row : batch) {
+                row = pick_row(random);
+            }
+            Assign(data, row_squared_norms, result.centroids, batch_assignments, batch_distances, num_threads, batch);
+            for (size_t i = 0; i < batch_size; i++) {
+                const auto centroid = batch_assignments[i];
+                const auto learning_rate = 1.0f / static_cast<float>(++seen[centroid]);
+                const auto* vector = data.GetVector(batch[i]);
+                auto* centroid_vector = result.centroids.data() + centroid * dimensions;
+                for (size_t j = 0; j < dimensions; j++) {
+                    centroid_vector[j] += learning_rate * (vector[j] - centroid_vector[j]);
+                }
+            }
+            if (options_.metric == VectorMetric::COSINE) {
+                for (size_t centroid = 0; centroid < k; centroid++) {
+                    Normalize(result.centroids.data() + centroid * dimensions, dimensions);
+                }
+            }
+        }
+    }
+
+    if (!converged) {
+        Assign(data, row_squared_norms, result.centroids, result.assignments, result.distances, num_threads);
+    }
+    result.cluster_sizes.assign(k, 0);
+    for (size_t row = 0; row < num_rows; row++) {
+        result.cluster_sizes[result.assignments[row]]++;
+        result.distances[row] = ToOutputDistance(result.distances[row]);
+    }
+    return result;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,52 @@
+#include "flockmtl/vector/metric.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+VectorMetric VectorMetricUtil::FromString(const std::string& metric) {
+    auto name = metric;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name == "cosine") {
+        return VectorMetric::COSINE;
+    }
+    if (name == "l2") {
+        return VectorMetric::L2;
+    }
+    if (name == "ip" || name == "inner_product") {
+        return VectorMetric::INNER_PRODUCT;
+    }
+    throw std::runtime_error("Unsupported metric '" + metric + "', expected 'cosine', 'l2' or 'ip'.");
+}
+
+std::string VectorMetricUtil::ToString(const VectorMetric metric) {
+    switch (metric) {
+    case VectorMetric::COSINE:
+        return "cosine";
+    case VectorMetric::L2:
+        return "l2";
+    case VectorMetric::INNER_PRODUCT:
+        return "ip";
+    }
+    return "";
+}
+
+float VectorMetricUtil::Distance(const VectorMetric metric, const float* a, const float* b, const size_t size) {
+    switch (metric) {
+    case VectorMetric::COSINE: {
+        const auto norms = std::sqrt(VectorKernels::SquaredNorm(a, size) * VectorKernels::SquaredNorm(b, size));
+        return norms > 0 ? 1.0f - VectorKernels::InnerProduct(a, b, size) / norms : 1.0f;
+    }
+    case VectorMetric::L2:
+        return std::sqrt(VectorKernels::L2SquaredDistance(a, b, size));
+    case VectorMetric::INNER_PRODUCT:
+        return -VectorKernels::InnerProduct(a, b, size);
+    }
+    return 0;
+}
+
+} // namespace flockmtl
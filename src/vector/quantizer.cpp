@@ -0,0 +1,37 @@
+#include "flockmtl/vector/quantizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+void Quantizer::QuantizeInt8(const float* vector, const size_t size, int8_t* out) {
+    float max_abs = 0;
+    for (size_t i = 0; i < size; i++) {
+        max_abs = std::max(max_abs, std::fabs(vector[i]));
+    }
+    const auto scale = max_abs > 0 ? 127.0f / max_abs : 0.0f;
+    for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<int8_t>(std::lround(vector[i] * scale));
+    }
+}
+
+void Quantizer::QuantizeBinary(const float* vector, const size_t size, uint8_t* out) {
+    std::memset(out, 0, GetBinarySize(size));
+    for (size_t i = 0; i < size; i++) {
+        if (vector[i] > 0) {
+            out[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+    }
+}
+
+float Quantizer::Int8CosineSimilarity(const int8_t* a, const int8_t* b, const size_t size) {
+    const auto norms = std::sqrt(static_cast<double>(VectorKernels::Int8InnerProduct(a, a, size)) *
+                                 VectorKernels::Int8InnerProduct(b, b, size));
+    return norms > 0 ? static_cast<float>(VectorKernels::Int8InnerProduct(a, b, size) / norms) : 0.0f;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,122 @@
+#include "flockmtl/vector/rescore_search.hpp"
+
+#include <algorithm>
+
+#include "duckdb/parser/keyword_helper.hpp"
+#include "flockmtl/vector/float_vector.hpp"
+#include "flockmtl/vector/kernels.hpp"
+#include "flockmtl/vector/quantizer.hpp"
+
+namespace flockmtl {
+
+RescoreSearch::RescoreSearch(const VectorMetric metric, std::vector<float> query, const size_t k,
+                             const size_t oversample)
+    : metric_(metric), query_(std::move(query)), k_(k), oversample_(std::max<size_t>(oversample, 1)) {}
+
+std::vector<int64_t> RescoreSearch::GetCandidates(duckdb::Connection& con, const EmbeddingSource& source,
+                                                  const std::string& quantized_column) const {
+    const auto quoted_column = duckdb::KeywordHelper::WriteOptionallyQuoted(quantized_column);
+    auto result = con.SendQuery(duckdb_fmt::format(" SELECT {}::BIGINT, {} "
+                                                   "   FROM {} "
+                                                   "  WHERE {} IS NOT NULL; ",
+                                                   source.GetQuotedKey(), quoted_column, source.GetQuotedTable(),
+                                                   quoted_column));
+    if (result->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to read the quantized column '{}' of table '{}': {}",
+                                                    quantized_column, source.table_name, result->GetError()));
+    }
+    const auto& code_type = result->types[1];
+    const auto is_binary = code_type.id() == duckdb::LogicalTypeId::BLOB;
+    if (!is_binary) {
+        Int8VectorReader::GetCastType(code_type, "vector_search_rescore");
+    }
+
+    std::vector<uint8_t> binary_query(Quantizer::GetBinarySize(query_.size()));
+    std::vector<int8_t> int8_query(query_.size());
+    Quantizer::QuantizeBinary(query_.data(), query_.size(), binary_query.data());
+    Quantizer::QuantizeInt8(query_.data(), query_.size(), int8_query.data());
+
+    // Max-heap of the best candidates so far, by Hamming distance or int8 cosine distance
+    const auto num_candidates = k_ * oversample_;
+    std::vector<std::pair<float, int64_t>> heap;
+    auto push = [&](const float distance, const int64_t key) {
+        if (heap.size() < num_candidates) {
+            heap.emplace_back(distance, key);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (distance < heap.front().first) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = {distance, key};
+            std::push_heap(heap.begin(), heap.end());
+        }
+    };
+
+    while (auto chunk = result->Fetch()) {
+        auto& keys = chunk->data[0];
+        keys.Flatten(chunk->size());
+        const auto key_data = duckdb::FlatVector::GetData<int64_t>(keys);
+        const auto& key_validity = duckdb::FlatVector::Validity(keys);
+
+        if (is_binary) {
+            auto& codes = chunk->data[1];
+            codes.Flatten(chunk->size());
+            const auto code_data = duckdb::FlatVector::GetData<duckdb::string_t>(codes);
+            for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+                if (!key_validity.RowIsValid(row)) {
+                    continue;
+                }
+                if (code_data[row].GetSize() != binary_query.size()) {
+                    throw std::runtime_error(duckdb_fmt::format(
+                        "The binary code of the row with key {} has {} bytes, expected {} for {} dimensions.",
+                        key_data[row], code_data[row].GetSize(), binary_query.size(), query_.size()));
+                }
+                const auto distance = VectorKernels::HammingDistance(
+                    binary_query.data(), reinterpret_cast<const uint8_t*>(code_data[row].GetData()),
+                    binary_query.size());
+                push(static_cast<float>(distance), key_data[row]);
+            }
+        } else {
+            const Int8VectorReader codes(chunk->data[1], chunk->size());
+            for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+                const int8_t* code;
+                duckdb::idx_t size;
+                if (!key_validity.RowIsValid(row) || !codes.Get(row, code, size)) {
+                    continue;
+                }
+                if (size != int8_query.size()) {
+                    throw std::runtime_error(
+                        duckdb_fmt::format("The int8 code of the row with key {} has {} dimensions, expected {}.",
+                                           key_data[row], size, int8_query.size()));
+                }
+                push(1.0f - Quantizer::Int8CosineSimilarity(int8_query.data(), code, size), key_data[row]);
+            }
+        }
+    }
+
+    std::vector<int64_t> candidates;
+    candidates.reserve(heap.size());
+    for (const auto& [distance, key] : heap) {
+        candidates.push_back(key);
+    }
+    return candidates;
+}
+
+ExactSearch::Result RescoreSearch::Run(duckdb::Connection& con, const EmbeddingSource& source,
+                                       const std::string& quantized_column) {
+    const auto candidates = GetCandidates(con, source, quantized_column);
+    if (candidates.empty()) {
+        return {};
+    }
+
+    // Only the candidates are read at full precision
+    std::string keys;
+    for (const auto key : candidates) {
+        keys += (keys.empty() ? "" : ", ") + std::to_string(key);
+    }
+    auto candidate_source = source;
+    candidate_source.filter = duckdb_fmt::format("{} IN ({})", source.GetQuotedKey(), keys);
+    EmbeddingScanner scanner(con, candidate_source);
+    ExactSearch search(metric_, {query_}, k_);
+    return search.Run(scanner, 1).front();
+}
+
+} // namespace flockmtl
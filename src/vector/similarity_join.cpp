@@ -0,0 +1,127 @@
+#include "flockmtl/vector/similarity_join.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flockmtl/vector/kernels.hpp"
+
+namespace flockmtl {
+
+SimilarityJoin::SimilarityJoin(EmbeddingBlock right, const SimilarityJoinOptions options)
+    : right_(std::move(right)), options_(options) {
+    PrepareVectors(right_, right_squared_norms_);
+}
+
+void SimilarityJoin::PrepareVectors(EmbeddingBlock& block, std::vector<float>& squared_norms) const {
+    squared_norms.resize(block.Size());
+    for (size_t row = 0; row < block.Size(); row++) {
+        auto* vector = block.vectors.data() + row * block.dimensions;
+        squared_norms[row] = VectorKernels::SquaredNorm(vector, block.dimensions);
+        // Normalized cosine vectors turn the whole join into inner products
+        if (options_.metric == VectorMetric::COSINE && squared_norms[row] > 0) {
+            const auto norm = std::sqrt(squared_norms[row]);
+            for (size_t i = 0; i < block.dimensions; i++) {
+                vector[i] /= norm;
+            }
+        }
+    }
+}
+
+float SimilarityJoin::ToDistance(const float inner_product, const float left_squared_norm,
+                                 const float right_squared_norm) const {
+    switch (options_.metric) {
+    case VectorMetric::COSINE:
+        return left_squared_norm > 0 && right_squared_norm > 0 ? 1.0f - inner_product : 1.0f;
+    case VectorMetric::L2:
+        return std::sqrt(std::max(0.0f, left_squared_norm + right_squared_norm - 2 * inner_product));
+    case VectorMetric::INNER_PRODUCT:
+        return -inner_product;
+    }
+    return 0;
+}
+
+void SimilarityJoin::JoinBlock(EmbeddingBlock& left, std::vector<SimilarityMatch>& matches) const {
+    const auto dimensions = left.dimensions;
+    std::vector<float> left_squared_norms;
+    PrepareVectors(left, left_squared_norms);
+
+    const auto tile_rows = std::max<size_t>(4, tile_bytes / (dimensions * sizeof(float)));
+    std::vector<float> inner_products(tile_rows);
+    // Best matches of every left row of the block, with the row of the right match, as max-heaps when the matches
+    // are limited to k
+    std::vector<std::vector<std::pair<float, int64_t>>> candidates(left.Size());
+
+    // Both tiles stay in cache while every pair between them is scored
+    for (size_t left_tile = 0; left_tile < left.Size(); left_tile += tile_rows) {
+        const auto left_tile_end = std::min(left_tile + tile_rows, left.Size());
+        for (size_t right_tile = 0; right_tile < right_.Size(); right_tile += tile_rows) {
+            const auto right_tile_size = std::min(tile_rows, right_.Size() - right_tile);
+            for (auto row = left_tile; row < left_tile_end; row++) {
+                VectorKernels::InnerProducts(left.GetVector(row), right_.GetVector(right_tile), right_tile_size,
+                                             dimensions, inner_products.data());
+                auto& heap = candidates[row];
+                for (size_t i = 0; i < right_tile_size; i++) {
+                    const auto distance = ToDistance(inner_products[i], left_squared_norms[row],
+                                                     right_squared_norms_[right_tile + i]);
+                    if (!(distance <= options_.max_distance)) {
+                        continue;
+                    }
+                    const auto right_row = static_cast<int64_t>(right_tile + i);
+                    if (options_.k == 0 || heap.size() < options_.k) {
+                        heap.emplace_back(distance, right_row);
+                        if (options_.k != 0) {
+                            std::push_heap(heap.begin(), heap.end());
+                        }
+                    } else if (distance < heap.front().first) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = {distance, right_row};
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t row = 0; row < left.Size(); row++) {
+        auto& heap = candidates[row];
+        if (options_.metric == VectorMetric::L2) {
+            // The expanded form loses precision between close vectors, the kept pairs get the direct distance
+            for (auto& [distance, right_row] : heap) {
+                distance = std::sqrt(
+                    VectorKernels::L2SquaredDistance(left.GetVector(row), right_.GetVector(right_row), dimensions));
+            }
+        }
+        std::sort(heap.begin(), heap.end());
+        for (const auto& [distance, right_row] : heap) {
+            if (distance <= options_.max_distance) {
+                matches.push_back({left.keys[row], right_.keys[right_row], distance});
+            }
+        }
+    }
+}
+
+std::vector<SimilarityMatch> SimilarityJoin::Run(EmbeddingScanner& left, const size_t num_threads) {
+    // Nothing can match an empty right table, whose dimensions are unknown
+    if (right_.Size() == 0) {
+        return {};
+    }
+    const auto num_workers = std::max<size_t>(num_threads, 1);
+    std::vector<std::vector<SimilarityMatch>> worker_matches(num_workers);
+    left.ScanParallel(num_workers, block_rows, [&](const size_t worker, EmbeddingBlock& block) {
+        if (block.dimensions != right_.dimensions) {
+            throw std::runtime_error(duckdb_fmt::format(
+                "The left embeddings have {} dimensions, but the right ones have {}.", block.dimensions,
+                right_.dimensions));
+        }
+        JoinBlock(block, worker_matches[worker]);
+    });
+
+    std::vector<SimilarityMatch> matches;
+    for (auto& worker_match : worker_matches) {
+        matches.insert(matches.end(), worker_match.begin(), worker_match.end());
+        std::vector<SimilarityMatch>().swap(worker_match);
+    }
+    return matches;
+}
+
+} // namespace flockmtl
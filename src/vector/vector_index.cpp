@@ -0,0 +1,337 @@
+#include "flockmtl/vector/vector_index.hpp"
+
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "duckdb/common/types/hash.hpp"
+#include "flockmtl/core/config.hpp"
+#include "flockmtl/vector/embedding_scanner.hpp"
+
+namespace flockmtl {
+
+namespace {
+
+// Version of a node, so that a refresh finds the rows whose embedding was updated since they were linked
+uint64_t GetEmbeddingVersion(const float* embedding, const size_t dimensions) {
+    return duckdb::Hash(reinterpret_cast<const char*>(embedding), dimensions * sizeof(float));
+}
+
+} // namespace
+
+std::mutex VectorIndexManager::cache_mutex_;
+std::map<std::string, VectorIndexManager::CachedIndex> VectorIndexManager::cache_;
+
+std::string VectorIndexManager::GetDefinitionQuery(const std::string& index_name) {
+    return duckdb_fmt::format(" SELECT table_name, key_column, embedding_column, metric, dimensions, m, "
+                              "        ef_construction, entry_point, max_level, updated_at::VARCHAR "
+                              "   FROM flockmtl_config.{} "
+                              "  WHERE index_name = '{}'; ",
+                              Config::get_vector_indexes_table_name(), index_name);
+}
+
+VectorIndexDefinition VectorIndexManager::GetDefinition(const std::string& index_name) {
+    auto con = Config::GetConnection();
+    const auto result = con.Query(GetDefinitionQuery(index_name));
+    if (result->HasError() || result->RowCount() == 0) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' does not exist.", index_name));
+    }
+    VectorIndexDefinition definition;
+    definition.index_name = index_name;
+    definition.table_name = result->GetValue(0, 0).ToString();
+    definition.key_column = result->GetValue(1, 0).ToString();
+    definition.embedding_column = result->GetValue(2, 0).ToString();
+    definition.metric = VectorMetricUtil::FromString(result->GetValue(3, 0).ToString());
+    definition.dimensions = result->GetValue(4, 0).GetValue<int64_t>();
+    definition.m = result->GetValue(5, 0).GetValue<int64_t>();
+    definition.ef_construction = result->GetValue(6, 0).GetValue<int64_t>();
+    return definition;
+}
+
+void VectorIndexManager::ScanSource(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                                    const std::function<void(int64_t, const float*)>& callback) {
+    EmbeddingScanner scanner(con, {definition.table_name, definition.key_column, definition.embedding_column});
+    EmbeddingBlock block;
+    while (scanner.Next(block)) {
+        if (block.dimensions != definition.dimensions) {
+            throw std::runtime_error(
+                duckdb_fmt::format("Vector index '{}' expects {} dimensions, but the table has {}.",
+                                   definition.index_name, definition.dimensions, block.dimensions));
+        }
+        for (size_t row = 0; row < block.Size(); row++) {
+            callback(block.keys[row], block.GetVector(row));
+        }
+    }
+}
+
+std::shared_ptr<HnswIndex> VectorIndexManager::Build(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                                                     const size_t num_threads) {
+    auto index = std::make_shared<HnswIndex>(definition.dimensions, definition.metric, definition.m,
+                                             definition.ef_construction);
+    std::unordered_set<int64_t> keys;
+    ScanSource(con, definition, [&](const int64_t key, const float* embedding) {
+        if (!keys.insert(key).second) {
+            throw std::runtime_error(duckdb_fmt::format("Vector index '{}' requires unique keys, but {} is repeated.",
+                                                        definition.index_name, key));
+        }
+        const auto node = index->Append(key, embedding);
+        index->SetVersion(node, GetEmbeddingVersion(embedding, definition.dimensions));
+    });
+    index->Link(num_threads);
+    return index;
+}
+
+std::shared_ptr<HnswIndex> VectorIndexManager::Load(duckdb::Connection& con, const VectorIndexDefinition& definition) {
+    const auto metadata = con.Query(GetDefinitionQuery(definition.index_name));
+    if (metadata->HasError() || metadata->RowCount() == 0) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' does not exist.", definition.index_name));
+    }
+
+    auto index = std::make_shared<HnswIndex>(definition.dimensions, definition.metric, definition.m,
+                                             definition.ef_construction);
+    std::unordered_map<int64_t, uint32_t> nodes;
+    // Nodes saved before their vectors were stored take the embedding of their row below
+    std::vector<uint8_t> has_vector;
+    std::vector<float> vector(definition.dimensions, 0.0f);
+    auto graph = con.SendQuery(duckdb_fmt::format(" SELECT row_key, neighbors, vector_hash, vector "
+                                                  "   FROM flockmtl_config.{} "
+                                                  "  WHERE index_name = '{}' "
+                                                  "  ORDER BY node_id; ",
+                                                  Config::get_vector_index_nodes_table_name(),
+                                                  definition.index_name));
+    if (graph->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to load vector index '{}': {}", definition.index_name,
+                                                    graph->GetError()));
+    }
+    while (auto chunk = graph->Fetch()) {
+        for (duckdb::idx_t row = 0; row < chunk->size(); row++) {
+            const auto key = chunk->GetValue(0, row).GetValue<int64_t>();
+            const auto saved_vector = chunk->GetValue(3, row);
+            const auto vector_size = vector.size() * sizeof(float);
+            const auto stored =
+                !saved_vector.IsNull() && duckdb::StringValue::Get(saved_vector).size() == vector_size;
+            if (stored) {
+                std::memcpy(vector.data(), duckdb::StringValue::Get(saved_vector).data(), vector_size);
+            } else {
+                std::fill(vector.begin(), vector.end(), 0.0f);
+            }
+            const auto node = index->Append(key, vector.data());
+            nodes[key] = node;
+            has_vector.push_back(stored);
+
+            // Neighbors are stored as the link count of each level followed by the linked node ids
+            const auto blob = duckdb::StringValue::Get(chunk->GetValue(1, row));
+            const auto words = reinterpret_cast<const uint32_t*>(blob.data());
+            const auto word_count = blob.size() / sizeof(uint32_t);
+            std::vector<std::vector<uint32_t>> links;
+            for (size_t offset = 0; offset < word_count; offset += words[offset] + 1) {
+                links.emplace_back(words + offset + 1, words + offset + 1 + words[offset]);
+            }
+            index->SetLinks(node, std::move(links));
+            // Nodes saved before versions were stored read as changed, and get linked again by the next refresh
+            const auto version = chunk->GetValue(2, row);
+            index->SetVersion(node, version.IsNull() ? 0 : version.GetValue<uint64_t>());
+        }
+    }
+
+    // Rows deleted from the table since the last build stay in the graph to route searches with their saved vector,
+    // but are never returned. Updated rows are searched with their new embedding, through links chosen for the old one
+    // until a refresh.
+    std::vector<uint8_t> found(index->Size(), 0);
+    ScanSource(con, definition, [&](const int64_t key, const float* embedding) {
+        if (const auto node = nodes.find(key); node != nodes.end()) {
+            index->SetVector(node->second, embedding);
+            found[node->second] = 1;
+        }
+    });
+    for (uint32_t node = 0; node < found.size(); node++) {
+        if (found[node]) {
+            continue;
+        }
+        if (!has_vector[node]) {
+            throw std::runtime_error(
+                duckdb_fmt::format("Vector index '{}' was saved without its vectors and rows were deleted from the "
+                                   "table since; drop and create it again.",
+                                   definition.index_name));
+        }
+        index->MarkDeleted(node);
+    }
+    index->Restore(metadata->GetValue(7, 0).GetValue<int64_t>(), metadata->GetValue(8, 0).GetValue<int32_t>());
+    return index;
+}
+
+std::string VectorIndexManager::Save(duckdb::Connection& con, const VectorIndexDefinition& definition,
+                                     const HnswIndex& index) {
+    con.BeginTransaction();
+    try {
+        const auto deleted = con.Query(duckdb_fmt::format(" DELETE FROM flockmtl_config.{} WHERE index_name = '{}'; ",
+                                                          Config::get_vector_index_nodes_table_name(),
+                                                          definition.index_name));
+        if (deleted->HasError()) {
+            throw std::runtime_error(deleted->GetError());
+        }
+        {
+            duckdb::Appender appender(con, Config::get_schema_name(), Config::get_vector_index_nodes_table_name());
+            std::vector<uint32_t> words;
+            for (uint32_t node = 0; node < index.Size(); node++) {
+                words.clear();
+                for (const auto& level : index.GetLinks(node)) {
+                    words.push_back(static_cast<uint32_t>(level.size()));
+                    words.insert(words.end(), level.begin(), level.end());
+                }
+                appender.BeginRow();
+                appender.Append(duckdb::Value(definition.index_name));
+                appender.Append(duckdb::Value::INTEGER(static_cast<int32_t>(node)));
+                appender.Append(duckdb::Value::BIGINT(index.GetKey(node)));
+                appender.Append(duckdb::Value::BLOB(reinterpret_cast<duckdb::const_data_ptr_t>(words.data()),
+                                                    words.size() * sizeof(uint32_t)));
+                appender.Append(duckdb::Value::UBIGINT(index.GetVersion(node)));
+                // Deleted rows keep routing searches after a reload, so every node keeps its own vector
+                appender.Append(duckdb::Value::BLOB(reinterpret_cast<duckdb::const_data_ptr_t>(index.GetVector(node)),
+                                                    index.GetDimensions() * sizeof(float)));
+                appender.EndRow();
+            }
+            appender.Close();
+        }
+        const auto result = con.Query(duckdb_fmt::format(
+            " INSERT OR REPLACE INTO flockmtl_config.{} "
+            " (index_name, table_name, key_column, embedding_column, metric, dimensions, m, ef_construction, "
+            "  entry_point, max_level, updated_at) "
+            " VALUES ('{}', '{}', '{}', '{}', '{}', {}, {}, {}, {}, {}, CURRENT_TIMESTAMP); ",
+            Config::get_vector_indexes_table_name(), definition.index_name, definition.table_name,
+            definition.key_column, definition.embedding_column, VectorMetricUtil::ToString(definition.metric),
+            definition.dimensions, definition.m, definition.ef_construction, index.GetEntryPoint(),
+            index.GetMaxLevel()));
+        if (result->HasError()) {
+            throw std::runtime_error(result->GetError());
+        }
+    } catch (const std::exception& e) {
+        con.Rollback();
+        throw std::runtime_error(
+            duckdb_fmt::format("Failed to save vector index '{}': {}", definition.index_name, e.what()));
+    }
+    con.Commit();
+    return GetUpdatedAt(con, definition.index_name);
+}
+
+std::string VectorIndexManager::GetUpdatedAt(duckdb::Connection& con, const std::string& index_name) {
+    const auto result = con.Query(GetDefinitionQuery(index_name));
+    if (result->HasError() || result->RowCount() == 0) {
+        return "";
+    }
+    return result->GetValue(9, 0).ToString();
+}
+
+size_t VectorIndexManager::Create(VectorIndexDefinition definition, const size_t num_threads) {
+    auto con = Config::GetConnection();
+    if (!GetUpdatedAt(con, definition.index_name).empty()) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' already exists.", definition.index_name));
+    }
+
+    // The dimensions are taken from the first embedding of the table
+    const EmbeddingSource source {definition.table_name, definition.key_column, definition.embedding_column};
+    const auto sample = con.Query(duckdb_fmt::format(" SELECT len({}::FLOAT[]) "
+                                                     "   FROM {} "
+                                                     "  WHERE {} IS NOT NULL "
+                                                     "  LIMIT 1; ",
+                                                     source.GetQuotedEmbedding(), source.GetQuotedTable(),
+                                                     source.GetQuotedEmbedding()));
+    if (sample->HasError()) {
+        throw std::runtime_error(duckdb_fmt::format("Failed to read the embeddings of vector index '{}': {}",
+                                                    definition.index_name, sample->GetError()));
+    }
+    if (sample->RowCount() == 0) {
+        throw std::runtime_error(
+            duckdb_fmt::format("Cannot create vector index '{}': the table has no embeddings.", definition.index_name));
+    }
+    definition.dimensions = sample->GetValue(0, 0).GetValue<int64_t>();
+
+    const auto index = Build(con, definition, num_threads);
+    const auto updated_at = Save(con, definition, *index);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[definition.index_name] = {updated_at, index};
+    return index->Size();
+}
+
+size_t VectorIndexManager::Refresh(const std::string& index_name, const size_t num_threads) {
+    const auto definition = GetDefinition(index_name);
+    auto con = Config::GetConnection();
+
+    // Searches may still run on the cached index, so the refresh works on its own copy
+    auto index = Load(con, definition);
+    std::unordered_map<int64_t, uint32_t> indexed_nodes;
+    for (uint32_t node = 0; node < index->Size(); node++) {
+        if (!index->IsDeleted(node)) {
+            indexed_nodes[index->GetKey(node)] = node;
+        }
+    }
+    std::unordered_set<int64_t> new_keys;
+    ScanSource(con, definition, [&](const int64_t key, const float* embedding) {
+        const auto version = GetEmbeddingVersion(embedding, definition.dimensions);
+        if (const auto node = indexed_nodes.find(key); node != indexed_nodes.end()) {
+            if (index->GetVersion(node->second) == version) {
+                return;
+            }
+            // The links of an updated row were chosen for its old embedding, so it is linked again as a new node
+            index->MarkDeleted(node->second);
+            indexed_nodes.erase(node);
+        }
+        if (!new_keys.insert(key).second) {
+            throw std::runtime_error(
+                duckdb_fmt::format("Vector index '{}' requires unique keys, but {} is repeated.", index_name, key));
+        }
+        const auto node = index->Append(key, embedding);
+        index->SetVersion(node, version);
+    });
+
+    if (index->GetDeletedCount() > rebuild_deleted_ratio * index->Size()) {
+        index = Build(con, definition, num_threads);
+    } else {
+        index->Link(num_threads);
+    }
+    const auto updated_at = Save(con, definition, *index);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[index_name] = {updated_at, index};
+    return index->Size() - index->GetDeletedCount();
+}
+
+void VectorIndexManager::Drop(const std::string& index_name) {
+    auto con = Config::GetConnection();
+    if (GetUpdatedAt(con, index_name).empty()) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' does not exist.", index_name));
+    }
+    con.BeginTransaction();
+    con.Query(duckdb_fmt::format(" DELETE FROM flockmtl_config.{} WHERE index_name = '{}'; ",
+                                 Config::get_vector_index_nodes_table_name(), index_name));
+    con.Query(duckdb_fmt::format(" DELETE FROM flockmtl_config.{} WHERE index_name = '{}'; ",
+                                 Config::get_vector_indexes_table_name(), index_name));
+    con.Commit();
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.erase(index_name);
+}
+
+std::shared_ptr<const HnswIndex> VectorIndexManager::Get(const std::string& index_name) {
+    auto con = Config::GetConnection();
+    const auto updated_at = GetUpdatedAt(con, index_name);
+    if (updated_at.empty()) {
+        throw std::runtime_error(duckdb_fmt::format("Vector index '{}' does not exist.", index_name));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (const auto cached = cache_.find(index_name);
+            cached != cache_.end() && cached->second.updated_at == updated_at) {
+            return cached->second.index;
+        }
+    }
+
+    const auto index = Load(con, GetDefinition(index_name));
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[index_name] = {updated_at, index};
+    return index;
+}
+
+} // namespace flockmtl
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Local stand-in for the OpenAI files and batches endpoints used by the offline execution mode.
+
+Every request of a batch is answered with one tuple per row of its prompt, `<batch number>:<row>`, so that the tests
+can tell which job produced a response. A batch goes through `validating` and `in_progress` before it completes, one
+status per poll.
+
+Usage:
+    python3 test/stubs/openai_batch_server.py                  # serves until interrupted
+    python3 test/stubs/openai_batch_server.py COMMAND [ARG...]  # runs COMMAND against the stub, then stops it
+
+COMMAND is run with FLOCKMTL_OPENAI_STUB_URL set to the base URL of the stub.
+"""
+
+import email.parser
+import json
+import os
+import subprocess
+import sys
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+STATUSES = ["validating", "in_progress", "completed"]
+
+
+class State:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.files = {}
+        self.batches = {}
+
+
+STATE = State()
+
+
+def complete(prompt, batch_number):
+    # Rows of the markdown table of the prompt, without its header and separator lines
+    rows = [line for line in prompt.splitlines() if line.startswith("|") and not line.startswith("|---")][1:]
+    tuples = []
+    for row in rows:
+        cell = row[1:].split(" | ")[0]
+        try:
+            value = json.loads(cell)
+        except ValueError:
+            value = cell
+        tuples.append("{}:{}".format(batch_number, value))
+    return {
+        "object": "chat.completion",
+        "choices": [
+            {
+                "index": 0,
+                "message": {"role": "assistant", "content": json.dumps({"tuples": tuples})},
+                "finish_reason": "stop",
+            }
+        ],
+        "usage": {"prompt_tokens": len(prompt) // 4, "completion_tokens": 8 * len(tuples)},
+    }
+
+
+def run_batch(batch_number, input_jsonl):
+    lines = []
+    for line in input_jsonl.splitlines():
+        if not line.strip():
+            continue
+        request = json.loads(line)
+        body = complete(request["body"]["messages"][0]["content"], batch_number)
+        lines.append(
+            json.dumps(
+                {
+                    "id": "response-{}".format(request["custom_id"]),
+                    "custom_id": request["custom_id"],
+                    "response": {"status_code": 200, "body": body},
+                    "error": None,
+                }
+            )
+        )
+    return "\n".join(lines) + "\n"
+
+
+class Handler(BaseHTTPRequestHandler):
+    def log_message(self, format, *args):
+        pass
+
+    def send_json(self, payload, status=200):
+        body = json.dumps(payload).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def read_body(self):
+        return self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+    def do_POST(self):
+        path = self.path.rstrip("/")
+        if path.endswith("/files"):
+            message = email.parser.BytesParser().parsebytes(
+                b"Content-Type: " + self.headers["Content-Type"].encode() + b"\r\n\r\n" + self.read_body()
+            )
+            content = ""
+            for part in message.walk():
+                if part.get_param("name", header="content-disposition") == "file":
+                    content = part.get_payload(decode=True).decode()
+            with STATE.lock:
+                file_id = "file-{}".format(len(STATE.files) + 1)
+                STATE.files[file_id] = content
+            return self.send_json({"id": file_id, "object": "file", "purpose": "batch"})
+        if path.endswith("/batches"):
+            request = json.loads(self.read_body())
+            with STATE.lock:
+                batch_number = len(STATE.batches) + 1
+                batch_id = "batch_{}".format(batch_number)
+                STATE.batches[batch_id] = {
+                    "number": batch_number,
+                    "input_file_id": request["input_file_id"],
+                    "polls": 0,
+                    "output_file_id": None,
+                }
+            return self.send_json({"id": batch_id, "object": "batch", "status": STATUSES[0]})
+        self.send_json({"error": {"message": "Unknown endpoint " + self.path}}, 404)
+
+    def do_GET(self):
+        parts = self.path.strip("/").split("/")
+        if len(parts) >= 2 and parts[-2] == "batches":
+            with STATE.lock:
+                batch = STATE.batches.get(parts[-1])
+                if batch is None:
+                    return self.send_json({"error": {"message": "No batch " + parts[-1]}}, 404)
+                status = STATUSES[min(batch["polls"], len(STATUSES) - 1)]
+                batch["polls"] += 1
+                if status == "completed" and batch["output_file_id"] is None:
+                    output_file_id = "file-{}".format(len(STATE.files) + 1)
+                    STATE.files[output_file_id] = run_batch(batch["number"], STATE.files[batch["input_file_id"]])
+                    batch["output_file_id"] = output_file_id
+                output_file_id = batch["output_file_id"] if status == "completed" else None
+            return self.send_json(
+                {
+                    "id": parts[-1],
+                    "object": "batch",
+                    "status": status,
+                    "output_file_id": output_file_id,
+                    "error_file_id": None,
+                }
+            )
+        if len(parts) >= 3 and parts[-3] == "files" and parts[-1] == "content":
+            with STATE.lock:
+                content = STATE.files.get(parts[-2])
+            if content is None:
+                return self.send_json({"error": {"message": "No file " + parts[-2]}}, 404)
+            body = content.encode()
+            self.send_response(200)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+            return
+        self.send_json({"error": {"message": "Unknown endpoint " + self.path}}, 404)
+
+
+def main():
+    server = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+    url = "http://127.0.0.1:{}/v1/".format(server.server_address[1])
+    if len(sys.argv) == 1:
+        print("Serving the OpenAI batch stub at " + url, flush=True)
+        server.serve_forever()
+        return 0
+
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    try:
+        return subprocess.call(sys.argv[1:], env=dict(os.environ, FLOCKMTL_OPENAI_STUB_URL=url))
+    finally:
+        server.shutdown()
+
+
+if __name__ == "__main__":
+    sys.exit(main())